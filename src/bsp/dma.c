@@ -0,0 +1,9 @@
+#include "dma.h"
+/* LCD_DMA, whether the LCD driver needs the control table. */
+#include "drivers/lcd/lcd.h"
+
+/* The SPL only defines the DMA control table for IAR, CMC-ARM and ARMCC. Primary and
+ * alternate structures for all 32 channels, the controller requires 1 KB alignment. */
+#if LCD_DMA && defined (__GNUC__) && !defined (__ARMCC_VERSION)
+DMA_CtrlDataTypeDef DMA_ControlTable[(32 * DMA_AlternateData) + DMA_Channels_Number] __attribute__ ((aligned (1024)));
+#endif
@@ -0,0 +1,6 @@
+#ifndef DMA_H_
+#define DMA_H_
+
+#include <MDR32FxQI_dma.h>
+
+#endif
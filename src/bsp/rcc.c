@@ -19,5 +19,8 @@ void rcc_config(void)
 	RST_CLK_CPU_PLLuse(ENABLE);
 
 	RST_CLK_CPUclkSelection(RST_CLK_CPUclkCPU_C3);
+
+	/* DELAY_Init() and the timer setups derive their counts from SystemCoreClock. */
+	SystemCoreClockUpdate();
 }
 
@@ -1,88 +1,432 @@
 #include "lcd.h"
 
-static void send_command(struct lcd *self, uint8_t command, uint8_t part);
-static void send_data(struct lcd *self, uint8_t data, uint8_t part);
+#include <string.h>
 
-void lcd_init(struct lcd *self) {
-    PORT_ResetBits(self->res_port, self->res_pin);
-    lcd_delay(100);
-    PORT_SetBits(self->res_port, self->res_pin);
-    lcd_delay(100);
-    send_command(self, 0x3F, LCD_PART_LEFT);
-    send_command(self, 0x3F, LCD_PART_RIGHT);
-    lcd_fill(self, 0);
+static void send_commands(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count);
+static void send_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length);
+static void panel_modify_run(struct lcd *self, uint8_t page, uint8_t column, uint8_t length, uint8_t mask, uint8_t mode);
+static uint8_t modify(uint8_t data, uint8_t mask, uint8_t mode);
+static uint8_t clip_run(uint8_t page, uint8_t column, uint8_t length);
+#if LCD_SHADOW
+static void shadow_write(struct lcd *self, uint8_t page, uint8_t column, uint8_t data);
+static void shadow_write_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length);
+static void mark_dirty(struct lcd *self, uint8_t page, uint8_t column);
+#endif
+
+/* Returns -1 without touching the panel when the transport cannot be set up. */
+int8_t lcd_init(struct lcd *self) {
+    const uint8_t display_on = 0x3F;
+
+    if (self->transport->init(self) < 0)
+        return -1;
+    send_commands(self, LCD_PART_LEFT, &display_on, 1);
+    send_commands(self, LCD_PART_RIGHT, &display_on, 1);
+    self->start_line = 0;
+
+#if LCD_SHADOW
+    /* Panel RAM content is unknown after reset, so the first flush rewrites everything. */
+    memset(&self->shadow, 0x00, sizeof(self->shadow));
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        self->dirty[i][0] = (struct lcd_dirty){0, LCD_PART_WIDTH};
+        self->dirty[i][1] = (struct lcd_dirty){LCD_PART_WIDTH, LCD_WIDTH};
+    }
+    lcd_flush(self);
+#else
+    /* Both chips latch the same page, column and data, so clearing takes one run per page. */
+    const uint8_t zeros[LCD_PART_WIDTH] = {0};
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        const uint8_t commands[2] = {0xB8|i, 0x40};
+        send_commands(self, LCD_PART_BOTH, commands, 2);
+        send_data_run(self, LCD_PART_BOTH, zeros, LCD_PART_WIDTH);
+    }
+#endif
+    return 0;
+}
+
+/* The reset pulse in transport init leaves the start line at 0 on both chips. */
+void lcd_set_start_line(struct lcd *self, uint8_t line) {
+    const uint8_t command = 0xC0|(line % LCD_HEIGHT);
+
+    self->start_line = line % LCD_HEIGHT;
+    send_commands(self, LCD_PART_BOTH, &command, 1);
+}
+
+/*
+ * Page-major run that may cross the chip boundary. With the shadow it only updates the
+ * shadow and lcd_flush() sends the changed bytes, without it the run goes out at once.
+ * Runs are clipped at the right edge, runs off the panel are dropped.
+ */
+void lcd_write_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length) {
+    length = clip_run(page, column, length);
+    while (length > 0) {
+        uint8_t half = column / LCD_PART_WIDTH;
+        uint8_t run = (half + 1) * LCD_PART_WIDTH - column;
+
+        if (run > length)
+            run = length;
+#if LCD_SHADOW
+        shadow_write_run(self, page, column, data, run);
+#else
+        uint8_t part = half ? LCD_PART_RIGHT : LCD_PART_LEFT;
+        const uint8_t commands[2] = {0xB8|page, 0x40|(column % LCD_PART_WIDTH)};
+        send_commands(self, part, commands, 2);
+        send_data_run(self, part, data, run);
+#endif
+
+        column += run;
+        data += run;
+        length -= run;
+    }
+}
+
+/*
+ * Like lcd_write_run() but only the bits in mask are replaced. Without the shadow the
+ * run is read back from the panel first, which needs a transport with read-back.
+ */
+int8_t lcd_merge_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length, uint8_t mask) {
+    length = clip_run(page, column, length);
+    if (length == 0)
+        return 0;
+#if LCD_SHADOW
+    for (uint8_t i = 0; i < length; i++) {
+        uint8_t *shadow = &self->shadow.pages[page][column + i];
+        shadow_write(self, page, column + i, (*shadow & ~mask) | (data[i] & mask));
+    }
+    return 0;
+#else
+    uint8_t merged[LCD_WIDTH];
+
+    if (lcd_read_data(self, page, column, merged, length) < 0)
+        return -1;
+    for (uint8_t i = 0; i < length; i++) {
+        merged[i] = (merged[i] & ~mask) | (data[i] & mask);
+    }
+    lcd_write_run(self, page, column, merged, length);
+    return 0;
+#endif
+}
+
+/*
+ * Sets, clears or inverts the bits in mask over a column run that may cross the chip
+ * boundary. With the shadow only the bytes that really change are marked dirty, without
+ * it the run is read, modified and written back on the panel.
+ */
+int8_t lcd_modify_run(struct lcd *self, uint8_t page, uint8_t column, uint8_t length, uint8_t mask, uint8_t mode) {
+    length = clip_run(page, column, length);
+    if (length == 0)
+        return 0;
+#if LCD_SHADOW
+    const uint8_t *shadow = &self->shadow.pages[page][column];
+    for (uint8_t i = 0; i < length; i++) {
+        shadow_write(self, page, column + i, modify(shadow[i], mask, mode));
+    }
+    return 0;
+#else
+    if (self->transport->read_data_run == NULL)
+        return -1;
+
+    while (length > 0) {
+        uint8_t run = (column / LCD_PART_WIDTH + 1) * LCD_PART_WIDTH - column;
+        if (run > length)
+            run = length;
+        panel_modify_run(self, page, column, run, mask, mode);
+        column += run;
+        length -= run;
+    }
+    return 0;
+#endif
 }
 
+/* Reads panel RAM directly, the run may cross the chip boundary. */
+int8_t lcd_read_data(struct lcd *self, uint8_t page, uint8_t column, uint8_t *data, uint8_t length) {
+    if (self->transport->read_data_run == NULL || page >= LCD_PAGES || column + length > LCD_WIDTH)
+        return -1;
+
+    while (length > 0) {
+        uint8_t half = column / LCD_PART_WIDTH;
+        uint8_t part = half ? LCD_PART_RIGHT : LCD_PART_LEFT;
+        uint8_t run = (half + 1) * LCD_PART_WIDTH - column;
+        const uint8_t commands[2] = {0xB8|page, 0x40|(column % LCD_PART_WIDTH)};
+
+        if (run > length)
+            run = length;
+        send_commands(self, part, commands, 2);
+        self->transport->read_data_run(self, part, data, run);
+
+        column += run;
+        data += run;
+        length -= run;
+    }
+    return 0;
+}
+
+/*
+ * Draws straight into panel RAM, bypassing the shadow: per page and chip the covered
+ * columns are read as one run, masked and written back as one run. Pages that are
+ * fully covered are written without reading unless mode is LCD_DRAW_XOR.
+ */
+int8_t lcd_panel_fill_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode) {
+    if (self->transport->read_data_run == NULL || x + width > LCD_WIDTH || y + height > LCD_HEIGHT)
+        return -1;
+
+    for (uint8_t line = y; line < y + height; line = (line | 0x07) + 1) {
+        uint8_t last = (y + height - line < 8 - line % 8) ? y + height - 1 : (line | 0x07);
+        uint8_t mask = (0xFF << (line % 8)) & (0xFF >> (7 - last % 8));
+
+        for (uint8_t column = x; column < x + width; ) {
+            uint8_t run = (column / LCD_PART_WIDTH + 1) * LCD_PART_WIDTH - column;
+            if (run > x + width - column)
+                run = x + width - column;
+            panel_modify_run(self, line / 8, column, run, mask, mode);
+            column += run;
+        }
+    }
+    return 0;
+}
+
+int8_t lcd_panel_set_pixel(struct lcd *self, uint8_t x, uint8_t y, uint8_t mode) {
+    return lcd_panel_fill_rect(self, x, y, 1, 1, mode);
+}
+
+#if LCD_SHADOW
 void lcd_fill(struct lcd *self, uint8_t color) {
-    for (int8_t i = 0; i < 8; i++)
-    {
-        send_command(self, (0xB8|i), LCD_PART_LEFT);
-        send_command(self, (0x40), LCD_PART_LEFT);
-        for (uint8_t i = 0; i < 64; i++) {
-            send_data(self, color ? 0xFF : 0x00, LCD_PART_LEFT);
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        for (uint8_t j = 0; j < LCD_WIDTH; j++) {
+            shadow_write(self, i, j, color ? 0xFF : 0x00);
+        }
+    }
+    lcd_flush(self);
+}
+
+void lcd_show_framebuffer(struct lcd *self, const struct lcd_framebuffer *fb) {
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        shadow_write_run(self, i, 0, fb->pages[i], LCD_PART_WIDTH);
+        shadow_write_run(self, i, LCD_PART_WIDTH, &fb->pages[i][LCD_PART_WIDTH], LCD_PART_WIDTH);
+    }
+    lcd_flush(self);
+}
+
+void lcd_flush(struct lcd *self) {
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        struct lcd_dirty *left = &self->dirty[i][0];
+        struct lcd_dirty *right = &self->dirty[i][1];
+        uint8_t shared = 0;
+
+        /* When both halves of a page change, the page (and, if it matches, the column)
+         * is set on both chips with a single strobe before the two data runs. */
+        if (left->start < left->end && right->start < right->end) {
+            const uint8_t commands[2] = {0xB8|i, 0x40|left->start};
+            shared = (left->start == right->start - LCD_PART_WIDTH) ? 2 : 1;
+            send_commands(self, LCD_PART_BOTH, commands, shared);
         }
-        send_command(self, (0xB8|i), LCD_PART_RIGHT);
-        send_command(self, (0x40), LCD_PART_RIGHT);
-        for (uint8_t i = 0; i < 64; i++) {
-            send_data(self, color ? 0xFF : 0x00, LCD_PART_RIGHT);
+
+        for (uint8_t half = 0; half < 2; half++) {
+            struct lcd_dirty *dirty = half ? right : left;
+            if (dirty->start >= dirty->end)
+                continue;
+
+            uint8_t part = half ? LCD_PART_RIGHT : LCD_PART_LEFT;
+            const uint8_t commands[2] = {0xB8|i, 0x40|(dirty->start - half * LCD_PART_WIDTH)};
+            if (shared < 2)
+                send_commands(self, part, &commands[shared], 2 - shared);
+            send_data_run(self, part, &self->shadow.pages[i][dirty->start], dirty->end - dirty->start);
+            dirty->start = LCD_WIDTH;
+            dirty->end = 0;
         }
     }
 }
 
+/*
+ * Marks a RAM area as differing from the panel, so the next flush resends it whatever
+ * the shadow holds. Overlapping areas merge in the dirty table into one run per page.
+ * The area is clipped at the right and bottom edges; -1 if it is empty or starts off
+ * the panel.
+ */
+int8_t lcd_invalidate(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    if (width == 0 || height == 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT)
+        return -1;
+    if (x + width > LCD_WIDTH)
+        width = LCD_WIDTH - x;
+    if (y + height > LCD_HEIGHT)
+        height = LCD_HEIGHT - y;
+
+    for (uint8_t page = y / 8; page <= (y + height - 1) / 8; page++) {
+        mark_dirty(self, page, x);
+        mark_dirty(self, page, x + width - 1);
+        /* A span across the chip boundary dirties the end of one half and the start of the other. */
+        if (x < LCD_PART_WIDTH && x + width > LCD_PART_WIDTH) {
+            mark_dirty(self, page, LCD_PART_WIDTH - 1);
+            mark_dirty(self, page, LCD_PART_WIDTH);
+        }
+    }
+    return 0;
+}
+
+/*
+ * Writes 128 page-major bytes to screen page row 0..7 as it is seen with the current
+ * start line. The row lands in one RAM page when the start line is a multiple of 8,
+ * otherwise it is shifted into two neighbouring pages.
+ */
+void lcd_view_write_page(struct lcd *self, uint8_t row, const uint8_t *data) {
+    uint8_t line = (row * 8 + self->start_line) % LCD_HEIGHT;
+    uint8_t page = line / 8;
+    uint8_t shift = line % 8;
+
+    if (shift == 0) {
+        shadow_write_run(self, page, 0, data, LCD_PART_WIDTH);
+        shadow_write_run(self, page, LCD_PART_WIDTH, &data[LCD_PART_WIDTH], LCD_PART_WIDTH);
+        return;
+    }
+
+    uint8_t next = (page + 1) % LCD_PAGES;
+    uint8_t keep = (1 << shift) - 1;
+    for (uint8_t j = 0; j < LCD_WIDTH; j++) {
+        shadow_write(self, page, j, (self->shadow.pages[page][j] & keep) | (data[j] << shift));
+        shadow_write(self, next, j, (self->shadow.pages[next][j] & ~keep) | (data[j] >> (8 - shift)));
+    }
+}
+
+/*
+ * Log-style scrolling: moves the picture up by one page and puts data into the
+ * bottom row. The page that scrolled off is the one that gets rewritten, so the bus
+ * sees one start line command and a single page of data.
+ */
+void lcd_scroll_page(struct lcd *self, const uint8_t *data) {
+    lcd_set_start_line(self, self->start_line + 8);
+    lcd_view_write_page(self, LCD_PAGES - 1, data);
+    lcd_flush(self);
+}
+
 void lcd_show_bitmap(struct lcd *self, uint8_t *bitmap) {
-    for (uint8_t i = 0; i < 8; i++) {
-        send_command(self, (0xB8|i), LCD_PART_LEFT);
-        send_command(self, (0x40), LCD_PART_LEFT);
-        for (uint8_t j = 0; j < 8; j++) {
-            for (uint8_t k = 0; k < 8; k++) {
-                uint8_t data = 0x00;
-                data |= (((bitmap[j+(i*128)])>>(7-k))&0x01)<<(0);
-                data |= (((bitmap[(j+16)+(i*128)])>>(7-k))&0x01)<<(1);
-                data |= (((bitmap[(j+32)+(i*128)])>>(7-k))&0x01)<<(2);
-                data |= (((bitmap[(j+48)+(i*128)])>>(7-k))&0x01)<<(3);
-                data |= (((bitmap[(j+64)+(i*128)])>>(7-k))&0x01)<<(4);
-                data |= (((bitmap[(j+80)+(i*128)])>>(7-k))&0x01)<<(5);
-                data |= (((bitmap[(j+96)+(i*128)])>>(7-k))&0x01)<<(6);
-                data |= (((bitmap[(j+112)+(i*128)])>>(7-k))&0x01)<<(7);
-                send_data(self, data, LCD_PART_LEFT);
-            }
-            
+    uint8_t columns[8];
+
+    for (uint8_t i = 0; i < LCD_PAGES; i++) {
+        for (uint8_t j = 0; j < LCD_WIDTH / 8; j++) {
+            lcd_transpose8(&bitmap[j + (i * 128)], 16, columns);
+            shadow_write_run(self, i, j * 8, columns, 8);
         }
     }
+    lcd_flush(self);
 }
 
+#endif
+
 __attribute__ ((weak)) int8_t lcd_delay(uint32_t us) {    
     return -1;
 }
 
-static void send_command(struct lcd *self, uint8_t command, uint8_t part) {
-    PORT_ResetBits(self->a0_port, self->a0_pin);
-    PORT_ResetBits(self->rw_port, self->rw_pin);
-    
-    PORT_ResetBits(part ? self->e2_port : self->e1_port, part ? self->e2_pin : self->e1_pin);
-    PORT_SetBits(part ? self->e1_port : self->e2_port, part ? self->e1_pin : self->e2_pin);
+/* The run must not cross the chip boundary. */
+static void panel_modify_run(struct lcd *self, uint8_t page, uint8_t column, uint8_t length, uint8_t mask, uint8_t mode) {
+    uint8_t part = column < LCD_PART_WIDTH ? LCD_PART_LEFT : LCD_PART_RIGHT;
+    const uint8_t commands[2] = {0xB8|page, 0x40|(column % LCD_PART_WIDTH)};
+    uint8_t overwrite = (mask == 0xFF && mode != LCD_DRAW_XOR);
+    uint8_t data[LCD_PART_WIDTH];
 
-    for (int i = 0; i < 8; i++) {
-        (command>>i & 0x01) ? PORT_SetBits(self->db_ports[i], self->db_pins[i]) : PORT_ResetBits(self->db_ports[i], self->db_pins[i]);
+    if (overwrite) {
+        memset(data, mode ? 0xFF : 0x00, length);
+    } else {
+        lcd_read_data(self, page, column, data, length);
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = modify(data[i], mask, mode);
+        }
     }
 
-    PORT_SetBits(self->e_port, self->e_pin);
-    lcd_delay(1);
-    PORT_ResetBits(self->e_port, self->e_pin);
+    /* Reads moved the column counter, the page is still set when we just read. */
+    if (overwrite)
+        send_commands(self, part, commands, 2);
+    else
+        send_commands(self, part, &commands[1], 1);
+    send_data_run(self, part, data, length);
 }
 
-static void send_data(struct lcd *self, uint8_t data, uint8_t part) {
-    PORT_SetBits(self->a0_port, self->a0_pin);
-    PORT_ResetBits(self->rw_port, self->rw_pin);
-    
-    PORT_ResetBits(part ? self->e2_port : self->e1_port, part ? self->e2_pin : self->e1_pin);
-    PORT_SetBits(part ? self->e1_port : self->e2_port, part ? self->e1_pin : self->e2_pin);
+static uint8_t modify(uint8_t data, uint8_t mask, uint8_t mode) {
+    if (mode == LCD_DRAW_XOR)
+        return data ^ mask;
+    return mode ? (data | mask) : (data & ~mask);
+}
 
-    for (int i = 0; i<8; i++) {
-        (data>>i & 0x01) ? PORT_SetBits(self->db_ports[i], self->db_pins[i]) : PORT_ResetBits(self->db_ports[i], self->db_pins[i]);
-    }
+/* Length of the part of a run that lies on the panel. */
+static uint8_t clip_run(uint8_t page, uint8_t column, uint8_t length) {
+    if (page >= LCD_PAGES || column >= LCD_WIDTH)
+        return 0;
+    return (length > LCD_WIDTH - column) ? LCD_WIDTH - column : length;
+}
+
+/*
+ * Turns 8 row-major bytes (MSB is the leftmost pixel, rows are stride bytes apart)
+ * into 8 page-major column bytes (LSB is the top row). Word-parallel 8x8 bit
+ * transpose from Hacker's Delight, fed with the rows bottom-up so that the top row
+ * ends up in bit 0.
+ */
+void lcd_transpose8(const uint8_t *rows, uint32_t stride, uint8_t *columns) {
+    uint32_t x = ((uint32_t)rows[7 * stride] << 24) | ((uint32_t)rows[6 * stride] << 16) |
+                 ((uint32_t)rows[5 * stride] << 8) | rows[4 * stride];
+    uint32_t y = ((uint32_t)rows[3 * stride] << 24) | ((uint32_t)rows[2 * stride] << 16) |
+                 ((uint32_t)rows[1 * stride] << 8) | rows[0];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
 
-    PORT_SetBits(self->e_port, self->e_pin);
-    lcd_delay(1);
-    PORT_ResetBits(self->e_port, self->e_pin);
-}
\ No newline at end of file
+    columns[0] = x >> 24;
+    columns[1] = x >> 16;
+    columns[2] = x >> 8;
+    columns[3] = x;
+    columns[4] = y >> 24;
+    columns[5] = y >> 16;
+    columns[6] = y >> 8;
+    columns[7] = y;
+}
+
+#if LCD_SHADOW
+
+static void shadow_write(struct lcd *self, uint8_t page, uint8_t column, uint8_t data) {
+    if (self->shadow.pages[page][column] == data)
+        return;
+
+    self->shadow.pages[page][column] = data;
+    mark_dirty(self, page, column);
+}
+
+/* The run must not cross the chip boundary. */
+static void shadow_write_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length) {
+    uint8_t *shadow = &self->shadow.pages[page][column];
+    uint8_t first = 0;
+    uint8_t last = length;
+
+    while (first < length && shadow[first] == data[first])
+        first++;
+    if (first == length)
+        return;
+    while (shadow[last - 1] == data[last - 1])
+        last--;
+
+    memcpy(&shadow[first], &data[first], last - first);
+    mark_dirty(self, page, column + first);
+    mark_dirty(self, page, column + last - 1);
+}
+
+static void mark_dirty(struct lcd *self, uint8_t page, uint8_t column) {
+    struct lcd_dirty *dirty = &self->dirty[page][column / LCD_PART_WIDTH];
+    if (column < dirty->start)
+        dirty->start = column;
+    if (column >= dirty->end)
+        dirty->end = column + 1;
+}
+#endif
+
+static void send_commands(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count) {
+    self->transport->write_cmds(self, part, commands, count);
+    self->bytes_sent += count;
+}
+
+static void send_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length) {
+    self->transport->write_data_run(self, part, data, length);
+    self->bytes_sent += length;
+}
@@ -3,12 +3,116 @@
 
 #include <MDR32FxQI_port.h>
 
+#define LCD_WIDTH       128
+#define LCD_HEIGHT      64
+#define LCD_PAGES       (LCD_HEIGHT / 8)
+#define LCD_PART_WIDTH  (LCD_WIDTH / 2)
+
 enum lcd_parts {
     LCD_PART_RIGHT = 0,
-    LCD_PART_LEFT
+    LCD_PART_LEFT,
+    LCD_PART_BOTH   /* write-only: commands and data latched by both chips at once */
+};
+
+/* Minimal E pulse width of the controller, the EBC wait states are derived from it. */
+#define LCD_EBC_ACCESS_NS   450
+
+/* How the driver waits for the controller to accept the next transfer. */
+enum lcd_wait_modes {
+    LCD_WAIT_DELAY = 0,     /* fixed lcd_delay() timings, RW is never raised */
+    LCD_WAIT_BUSY           /* poll the BUSY/RESET status bits before every transfer */
+};
+
+/* Status reads per chip before a panel that stays BUSY is given up on and the driver
+ * falls back to LCD_WAIT_DELAY; one read takes a few microseconds on the GPIO bus. */
+#ifndef LCD_BUSY_POLLS_MAX
+#define LCD_BUSY_POLLS_MAX  1000
+#endif
+
+/* What drawing does with the covered pixels; 0 and 1 double as colors. */
+enum lcd_draw_modes {
+    LCD_DRAW_CLEAR = 0,
+    LCD_DRAW_SET,
+    LCD_DRAW_XOR
+};
+
+/* Panel-native layout: each byte holds 8 vertical pixels (LSB on top) of one column of one page. */
+struct lcd_framebuffer {
+    uint8_t pages[LCD_PAGES][LCD_WIDTH];
+};
+
+/* Set to 0 on RAM-tight builds: drops the 1 KB shadow and everything built on it,
+ * the panel is then drawn with the read-modify-write lcd_panel_*() calls only. */
+#ifndef LCD_SHADOW
+#define LCD_SHADOW          1
+#endif
+
+/* Set to 1 for lcd_flush_dma() on the EBC transport. It brings in the DMA control table
+ * of src/bsp/dma.c (1 KB, 1 KB aligned), which takes the setting from this header. */
+#ifndef LCD_DMA
+#define LCD_DMA             0
+#endif
+
+#if LCD_DMA && !LCD_SHADOW
+#error "LCD_DMA sends the shadow and needs LCD_SHADOW"
+#endif
+
+#ifndef LCD_BUS_PORTS_MAX
+#define LCD_BUS_PORTS_MAX   2
+#endif
+
+/* DB pins of one port with their levels precomputed for every data nibble. */
+struct lcd_bus_port {
+    MDR_PORT_TypeDef *port;
+    uint32_t pins;      /* DB pins on this port */
+    uint32_t keep;      /* RXTX bits that are not DB pins (JTAG pins excluded) */
+    uint32_t lo[16];    /* pin levels for data bits 0..3 */
+    uint32_t hi[16];    /* pin levels for data bits 4..7 */
+};
+
+#define LCD_LATCH_UNKNOWN   0xFF
+
+/* Control and data lines as the hardware transports last drove them; the control
+ * levels are LCD_LATCH_UNKNOWN after reset, so the first transfer sets every line. */
+struct lcd_latch {
+    uint8_t part;
+    uint8_t a0;
+    uint8_t rw;
+    uint8_t data;
+    uint8_t data_valid; /* cleared whenever DB was switched to input */
+};
+
+/* Column range [start, end) of one page of one chip that differs from the panel RAM. */
+struct lcd_dirty {
+    uint8_t start;
+    uint8_t end;
+};
+
+struct lcd;
+
+/*
+ * Bus back end. Batches always target one part; LCD_PART_BOTH is valid for command and
+ * data writes, never for reads. Waiting for the controller between bytes is up to the
+ * back end.
+ */
+struct lcd_transport {
+    int8_t (*init)(struct lcd *self);   /* bus setup and controller reset, -1 if the bus cannot drive the panel */
+    void (*write_cmds)(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count);
+    void (*write_data_run)(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length);
+    uint8_t (*read_status)(struct lcd *self, uint8_t part);
+    /* Dummy read first, then length bytes from the current column on; one chip only. */
+    void (*read_data_run)(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length);
 };
 
+/* Bit-banged through PORT RXTX; E1, E2 and RES are GPIO in the hardware back ends. */
+extern const struct lcd_transport lcd_transport_gpio;
+/* DB, A0, RW and E driven by the External Bus Controller, transport_data is a struct lcd_ebc. */
+extern const struct lcd_transport lcd_transport_ebc;
+
 struct lcd {
+    const struct lcd_transport *transport;
+    void *transport_data;
+
     MDR_PORT_TypeDef *db_ports[8];
     uint32_t db_pins[8];
     MDR_PORT_TypeDef *e1_port;
@@ -23,13 +127,59 @@ struct lcd {
     uint32_t a0_pin;
     MDR_PORT_TypeDef *e_port;
     uint32_t e_pin;
+    uint8_t wait_mode;
+
+    /* Transfer counters, compare them over a fixed interval to get bytes/second per wait mode. */
+    uint32_t bytes_sent;
+    uint32_t busy_polls;
+    uint32_t busy_timeouts;     /* missing or stuck panel, wait_mode fell back to LCD_WAIT_DELAY */
+
+#if LCD_SHADOW
+    /* Copy of the panel RAM: columns 0..63 belong to the left chip, 64..127 to the right one. */
+    struct lcd_framebuffer shadow;
+    struct lcd_dirty dirty[LCD_PAGES][2];
+#endif
+    /* Display start line: screen row y shows RAM line (y + start_line) % LCD_HEIGHT.
+     * lcd_show_*() and lcd_fill() address RAM, only lcd_view_*() follow the start line. */
+    uint8_t start_line;
+
+    /* Data bus write plan built by lcd_init(); bus_ports is 0 when the DB pins
+     * are spread over more than LCD_BUS_PORTS_MAX ports. */
+    struct lcd_bus_port bus[LCD_BUS_PORTS_MAX];
+    uint8_t bus_ports;
+    struct lcd_latch latch;
 };
 
 int8_t lcd_delay(uint32_t us);
+#if LCD_DMA
+/* lcd_flush_dma() calls lcd_dma_wait() until the transfer is over, the DMA interrupt
+ * calls lcd_dma_done(); a task may sleep in the first until woken by the second. */
+void lcd_dma_wait(struct lcd *self);
+void lcd_dma_done(struct lcd *self);
+#endif
 
-void lcd_init(struct lcd *self);
+int8_t lcd_init(struct lcd *self);
+void lcd_set_start_line(struct lcd *self, uint8_t line);
+void lcd_write_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length);
+int8_t lcd_merge_run(struct lcd *self, uint8_t page, uint8_t column, const uint8_t *data, uint8_t length, uint8_t mask);
+int8_t lcd_read_data(struct lcd *self, uint8_t page, uint8_t column, uint8_t *data, uint8_t length);
+int8_t lcd_modify_run(struct lcd *self, uint8_t page, uint8_t column, uint8_t length, uint8_t mask, uint8_t mode);
+int8_t lcd_panel_fill_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode);
+int8_t lcd_panel_set_pixel(struct lcd *self, uint8_t x, uint8_t y, uint8_t mode);
+void lcd_transpose8(const uint8_t *rows, uint32_t stride, uint8_t *columns);
+#if LCD_SHADOW
 void lcd_show_bitmap(struct lcd *self, uint8_t *bitmap);
+void lcd_show_framebuffer(struct lcd *self, const struct lcd_framebuffer *fb);
 void lcd_fill(struct lcd *self, uint8_t color);
+void lcd_flush(struct lcd *self);
+int8_t lcd_invalidate(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void lcd_view_write_page(struct lcd *self, uint8_t row, const uint8_t *data);
+void lcd_scroll_page(struct lcd *self, const uint8_t *data);
+#endif
+#if LCD_DMA
+int8_t lcd_flush_dma(struct lcd *self);
+void lcd_dma_irq_handler(void);
+#endif
 
 
-#endif
\ No newline at end of file
+#endif
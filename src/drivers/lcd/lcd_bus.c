@@ -0,0 +1,49 @@
+#include "lcd_bus.h"
+
+void lcd_bus_reset(struct lcd *self) {
+    self->latch.part = LCD_LATCH_UNKNOWN;
+    self->latch.a0 = LCD_LATCH_UNKNOWN;
+    self->latch.rw = LCD_LATCH_UNKNOWN;
+    self->latch.data_valid = 0;
+    PORT_ResetBits(self->res_port, self->res_pin);
+    lcd_delay(100);
+    PORT_SetBits(self->res_port, self->res_pin);
+    if (self->wait_mode == LCD_WAIT_DELAY)
+        lcd_delay(100);
+}
+
+void lcd_bus_select(struct lcd *self, uint8_t part) {
+    if (self->latch.part == part)
+        return;
+
+    self->latch.part = part;
+    (part != LCD_PART_RIGHT) ? PORT_SetBits(self->e1_port, self->e1_pin) : PORT_ResetBits(self->e1_port, self->e1_pin);
+    (part != LCD_PART_LEFT) ? PORT_SetBits(self->e2_port, self->e2_pin) : PORT_ResetBits(self->e2_port, self->e2_pin);
+}
+
+/*
+ * Returns -1 when a chip is still BUSY or in RESET after LCD_BUSY_POLLS_MAX reads. The
+ * wait mode is then switched to LCD_WAIT_DELAY for good, so a missing or hung panel
+ * slows the caller down to the fixed timings instead of blocking it.
+ */
+int8_t lcd_bus_wait_ready(struct lcd *self, uint8_t part) {
+    if (self->wait_mode != LCD_WAIT_BUSY)
+        return 0;
+
+    /* BUSY and RESET can only be read from one chip at a time. */
+    for (uint8_t half = 0; half < 2; half++) {
+        uint8_t chip = half ? LCD_PART_RIGHT : LCD_PART_LEFT;
+        uint32_t polls = 0;
+        if (part != LCD_PART_BOTH && part != chip)
+            continue;
+        while (self->transport->read_status(self, chip) & 0x90) {
+            self->busy_polls++;
+            if (++polls == LCD_BUSY_POLLS_MAX) {
+                self->busy_timeouts++;
+                self->wait_mode = LCD_WAIT_DELAY;
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef LCD_BUS_H_
+#define LCD_BUS_H_
+
+#include "lcd.h"
+
+/* Control lines shared by the hardware transports (E1, E2 and RES are always GPIO). */
+void lcd_bus_reset(struct lcd *self);
+void lcd_bus_select(struct lcd *self, uint8_t part);
+int8_t lcd_bus_wait_ready(struct lcd *self, uint8_t part);
+
+#endif
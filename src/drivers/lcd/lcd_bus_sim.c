@@ -0,0 +1,187 @@
+#include "lcd_bus_sim.h"
+
+#include <stddef.h>
+#include <string.h>
+
+static void port_write(MDR_PORT_TypeDef *port, uint32_t value);
+static void strobe_rise(struct lcd_bus_sim *sim);
+static void strobe_fall(struct lcd_bus_sim *sim);
+static uint8_t level(MDR_PORT_TypeDef *port, uint32_t pin);
+static uint8_t selected(const struct lcd_bus_sim *sim, uint8_t chip);
+static char port_name(const MDR_PORT_TypeDef *port);
+
+MDR_PORT_TypeDef lcd_bus_sim_ports[LCD_BUS_SIM_PORTS];
+
+static struct lcd_bus_sim *active;
+
+void lcd_bus_sim_attach(struct lcd_bus_sim *sim, const struct lcd *lcd, FILE *trace) {
+    memset(sim, 0, sizeof(*sim));
+    memset(lcd_bus_sim_ports, 0, sizeof(lcd_bus_sim_ports));
+    lcd_sim_reset(&sim->panel);
+    sim->lcd = lcd;
+    sim->trace = trace;
+    sim->e_settled = 1;
+    active = sim;
+}
+
+void lcd_bus_sim_reset_counters(struct lcd_bus_sim *sim) {
+    sim->reg_reads = 0;
+    sim->reg_writes = 0;
+    sim->strobes = 0;
+    sim->commands = 0;
+    sim->data = 0;
+    sim->reads = 0;
+    sim->delay_us = 0;
+    sim->short_edges = 0;
+}
+
+void lcd_bus_sim_report(const struct lcd_bus_sim *sim, const char *label, FILE *out) {
+    fprintf(out, "%-24s reg r/w %7lu %7lu  strobes %6lu  cmd %5lu  data %6lu  reads %6lu  delay %6lu us\n", label,
+            (unsigned long)sim->reg_reads, (unsigned long)sim->reg_writes, (unsigned long)sim->strobes,
+            (unsigned long)sim->commands, (unsigned long)sim->data, (unsigned long)sim->reads,
+            (unsigned long)sim->delay_us);
+}
+
+/* Replaces the weak one of lcd.c. Time is not simulated, only whether E got its delay. */
+int8_t lcd_delay(uint32_t us) {
+    if (active == NULL)
+        return 0;
+
+    active->delay_us += us;
+    active->e_settled = 1;
+    if (active->trace != NULL)
+        fprintf(active->trace, "DELAY %lu\n", (unsigned long)us);
+    return 0;
+}
+
+uint32_t lcd_bus_sim_read(volatile uint32_t *reg) {
+    if (active != NULL)
+        active->reg_reads++;
+    return *reg;
+}
+
+/* Only RXTX has side effects; OE and the other registers are plain storage. */
+void lcd_bus_sim_write(volatile uint32_t *reg, uint32_t value) {
+    for (int i = 0; i < LCD_BUS_SIM_PORTS; i++) {
+        if (reg == &lcd_bus_sim_ports[i].RXTX) {
+            port_write(&lcd_bus_sim_ports[i], value);
+            return;
+        }
+    }
+    if (active != NULL)
+        active->reg_writes++;
+    *reg = value;
+}
+
+/* The SPL functions as implemented for K1986VE9xI: one read-modify-write of RXTX. */
+void PORT_SetBits(MDR_PORT_TypeDef *MDR_PORTx, uint32_t PORT_Pin) {
+    if (active != NULL)
+        active->reg_reads++;
+    port_write(MDR_PORTx, (MDR_PORTx->RXTX | PORT_Pin) & ~JTAG_PINS(MDR_PORTx));
+}
+
+void PORT_ResetBits(MDR_PORT_TypeDef *MDR_PORTx, uint32_t PORT_Pin) {
+    if (active != NULL)
+        active->reg_reads++;
+    port_write(MDR_PORTx, (MDR_PORTx->RXTX & ~PORT_Pin) & ~JTAG_PINS(MDR_PORTx));
+}
+
+static void port_write(MDR_PORT_TypeDef *port, uint32_t value) {
+    struct lcd_bus_sim *sim = active;
+    uint32_t old = port->RXTX;
+
+    port->RXTX = value;
+    if (sim == NULL)
+        return;
+
+    sim->reg_writes++;
+    if (sim->trace != NULL)
+        fprintf(sim->trace, "PORT%c RXTX %08lX\n", port_name(port), (unsigned long)value);
+
+    const struct lcd *lcd = sim->lcd;
+    if (port == lcd->e_port && ((old ^ value) & lcd->e_pin)) {
+        /* Both the high and the low phase of E need their minimum time. */
+        if (!sim->e_settled)
+            sim->short_edges++;
+        sim->e_settled = 0;
+        (value & lcd->e_pin) ? strobe_rise(sim) : strobe_fall(sim);
+    }
+    if (port == lcd->res_port && (old & lcd->res_pin) && !(value & lcd->res_pin))
+        lcd_sim_reset(&sim->panel);
+}
+
+/* On a read cycle the selected chip drives DB while E is high. */
+static void strobe_rise(struct lcd_bus_sim *sim) {
+    const struct lcd *lcd = sim->lcd;
+    uint8_t chip = selected(sim, 0) ? 0 : 1;
+    uint8_t value;
+
+    sim->strobes++;
+    if (!level(lcd->rw_port, lcd->rw_pin))
+        return;
+
+    sim->reads++;
+    if (!level(lcd->a0_port, lcd->a0_pin)) {
+        value = lcd_sim_status(&sim->panel, chip);
+        if (sim->stuck) {
+            value |= 0x80;
+        } else if (sim->busy[chip] > 0) {
+            sim->busy[chip]--;
+            value |= 0x80;
+        }
+    } else {
+        value = lcd_sim_read(&sim->panel, chip);
+    }
+
+    for (uint8_t i = 0; i < 8; i++) {
+        if (value & (1 << i))
+            lcd->db_ports[i]->RXTX |= lcd->db_pins[i];
+        else
+            lcd->db_ports[i]->RXTX &= ~lcd->db_pins[i];
+    }
+    if (sim->trace != NULL)
+        fprintf(sim->trace, "E %c %s %02X\n", chip ? 'R' : 'L', level(lcd->a0_port, lcd->a0_pin) ? "read" : "status", value);
+}
+
+/* On a write cycle every selected chip latches DB on the falling edge. */
+static void strobe_fall(struct lcd_bus_sim *sim) {
+    const struct lcd *lcd = sim->lcd;
+    uint8_t a0 = level(lcd->a0_port, lcd->a0_pin);
+    uint8_t value = 0;
+
+    if (level(lcd->rw_port, lcd->rw_pin))
+        return;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        if (level(lcd->db_ports[i], lcd->db_pins[i]))
+            value |= 1 << i;
+    }
+
+    a0 ? sim->data++ : sim->commands++;
+    for (uint8_t chip = 0; chip < 2; chip++) {
+        if (!selected(sim, chip))
+            continue;
+        a0 ? lcd_sim_write(&sim->panel, chip, value) : lcd_sim_command(&sim->panel, chip, value);
+        sim->busy[chip] = sim->busy_polls;
+    }
+    if (sim->trace != NULL)
+        fprintf(sim->trace, "E %s %s %02X\n", selected(sim, 0) ? (selected(sim, 1) ? "LR" : "L") : "R",
+                a0 ? "data" : "cmd", value);
+}
+
+static uint8_t level(MDR_PORT_TypeDef *port, uint32_t pin) {
+    return (port->RXTX & pin) != 0;
+}
+
+/* E1 selects the left chip (0), E2 the right one (1). */
+static uint8_t selected(const struct lcd_bus_sim *sim, uint8_t chip) {
+    const struct lcd *lcd = sim->lcd;
+
+    return chip ? level(lcd->e2_port, lcd->e2_pin) : level(lcd->e1_port, lcd->e1_pin);
+}
+
+static char port_name(const MDR_PORT_TypeDef *port) {
+    if (port < lcd_bus_sim_ports || port >= lcd_bus_sim_ports + LCD_BUS_SIM_PORTS)
+        return '?';
+    return 'A' + (port - lcd_bus_sim_ports);
+}
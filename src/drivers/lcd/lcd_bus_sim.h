@@ -0,0 +1,49 @@
+#ifndef LCD_BUS_SIM_H_
+#define LCD_BUS_SIM_H_
+
+#include "lcd_sim.h"
+
+#include <stdio.h>
+
+/*
+ * Host replacement for the GPIO ports: lcd_transport_gpio runs unchanged against a fake
+ * register bank, the E strobes are decoded into a virtual panel and every register access
+ * is counted. Build with LCD_BUS_SIM (target lcd_bus_sim_driver), map the pins of the
+ * struct lcd to lcd_bus_sim_ports[0..5] (PORTA..PORTF) and attach it before lcd_init().
+ */
+#define LCD_BUS_SIM_PORTS   6
+
+extern MDR_PORT_TypeDef lcd_bus_sim_ports[LCD_BUS_SIM_PORTS];
+
+struct lcd_bus_sim {
+    struct lcd_sim panel;
+    const struct lcd *lcd;
+    FILE *trace;            /* one line per RXTX write, E strobe and delay, NULL for none */
+    uint8_t busy_polls;     /* status reads answered with BUSY after every write strobe */
+    uint8_t stuck;          /* every status read answered with BUSY, a hung panel */
+
+    /* Compare them around one operation after lcd_bus_sim_reset_counters(). PORT_SetBits()
+     * and PORT_ResetBits() count a read and a write, like the RXTX update they do on chip. */
+    uint32_t reg_reads;
+    uint32_t reg_writes;
+    uint32_t strobes;       /* E pulses of any kind */
+    uint32_t commands;
+    uint32_t data;
+    uint32_t reads;         /* status and data read strobes */
+    uint32_t delay_us;      /* lcd_delay() total */
+    uint32_t short_edges;   /* E edges with no lcd_delay() since the previous edge */
+
+    uint8_t e_settled;      /* lcd_delay() called since the last E edge */
+
+    uint8_t busy[2];
+};
+
+void lcd_bus_sim_attach(struct lcd_bus_sim *sim, const struct lcd *lcd, FILE *trace);
+void lcd_bus_sim_reset_counters(struct lcd_bus_sim *sim);
+void lcd_bus_sim_report(const struct lcd_bus_sim *sim, const char *label, FILE *out);
+
+/* Register access of the GPIO transport, see LCD_PORT_READ() in lcd_gpio.c. */
+uint32_t lcd_bus_sim_read(volatile uint32_t *reg);
+void lcd_bus_sim_write(volatile uint32_t *reg, uint32_t value);
+
+#endif
@@ -0,0 +1,157 @@
+#include "lcd_draw.h"
+
+static uint8_t clip(uint8_t start, uint8_t length, uint8_t limit);
+static uint8_t page_mask(uint8_t page, uint8_t first, uint8_t last);
+
+const struct lcd_pattern lcd_pattern_clear = {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}};
+const struct lcd_pattern lcd_pattern_solid = {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}};
+const struct lcd_pattern lcd_pattern_checker = {{0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA}};
+const struct lcd_pattern lcd_pattern_stipple = {{0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00}};
+const struct lcd_pattern lcd_pattern_hatch = {{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80}};
+
+void lcd_draw_pixel(struct lcd *self, uint8_t x, uint8_t y, uint8_t mode) {
+    if (x < LCD_WIDTH && y < LCD_HEIGHT)
+        lcd_modify_run(self, y / 8, x, 1, 1 << (y % 8), mode);
+}
+
+/* One bit in one page: a single masked run. */
+void lcd_draw_hline(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t mode) {
+    width = clip(x, width, LCD_WIDTH);
+    if (width > 0 && y < LCD_HEIGHT)
+        lcd_modify_run(self, y / 8, x, width, 1 << (y % 8), mode);
+}
+
+void lcd_draw_vline(struct lcd *self, uint8_t x, uint8_t y, uint8_t height, uint8_t mode) {
+    lcd_draw_box(self, x, y, 1, height, mode);
+}
+
+/*
+ * Bresenham, emitting the pixels that share a row (shallow lines) or a column (steep
+ * lines) as one hline or vline instead of one masked byte each.
+ */
+void lcd_draw_line(struct lcd *self, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t mode) {
+    int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int16_t dy = (y1 > y0) ? y1 - y0 : y0 - y1;
+    uint8_t t;
+
+    if (dx >= dy) {
+        if (x0 > x1) {
+            t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+        }
+        int8_t step = (y0 < y1) ? 1 : -1;
+        int16_t err = dx / 2;
+        uint8_t start = x0;
+
+        for (uint8_t x = x0; x <= x1; x++) {
+            err -= dy;
+            if (err < 0 || x == x1) {
+                lcd_draw_hline(self, start, y0, x - start + 1, mode);
+                start = x + 1;
+                y0 += step;
+                err += dx;
+            }
+            if (x == 0xFF)
+                break;
+        }
+    } else {
+        if (y0 > y1) {
+            t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+        }
+        int8_t step = (x0 < x1) ? 1 : -1;
+        int16_t err = dy / 2;
+        uint8_t start = y0;
+
+        for (uint8_t y = y0; y <= y1; y++) {
+            err -= dx;
+            if (err < 0 || y == y1) {
+                lcd_draw_vline(self, x0, start, y - start + 1, mode);
+                start = y + 1;
+                x0 += step;
+                err += dy;
+            }
+            if (y == 0xFF)
+                break;
+        }
+    }
+}
+
+/*
+ * Outline; the sides leave out the corners so that XOR does not flip them twice. The
+ * far edges are computed in int, an edge past the screen is skipped rather than wrapped.
+ */
+void lcd_draw_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode) {
+    int right = x + width - 1;
+    int bottom = y + height - 1;
+
+    if (width == 0 || height == 0)
+        return;
+
+    lcd_draw_hline(self, x, y, width, mode);
+    if (height > 1 && bottom < LCD_HEIGHT)
+        lcd_draw_hline(self, x, bottom, width, mode);
+    if (height > 2 && y + 1 < LCD_HEIGHT) {
+        lcd_draw_vline(self, x, y + 1, height - 2, mode);
+        if (width > 1 && right < LCD_WIDTH)
+            lcd_draw_vline(self, right, y + 1, height - 2, mode);
+    }
+}
+
+/*
+ * Filled rectangle, one masked run per page: whole bytes in the pages it covers
+ * completely, a partial mask only in its top and bottom page.
+ */
+void lcd_draw_box(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode) {
+    width = clip(x, width, LCD_WIDTH);
+    height = clip(y, height, LCD_HEIGHT);
+    if (width == 0 || height == 0)
+        return;
+
+    uint8_t last = y + height - 1;
+    for (uint8_t page = y / 8; page <= last / 8; page++) {
+        lcd_modify_run(self, page, x, width, page_mask(page, y, last), mode);
+    }
+}
+
+/*
+ * Replaces the covered pixels with the pattern. Fully covered pages are plain runs of
+ * tile bytes, so solid fills and clears reach the bus as runs of one repeated byte.
+ * Returns -1 when partial pages cannot be merged (no shadow and no read-back).
+ */
+int8_t lcd_fill_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const struct lcd_pattern *pattern) {
+    uint8_t data[LCD_WIDTH];
+
+    width = clip(x, width, LCD_WIDTH);
+    height = clip(y, height, LCD_HEIGHT);
+    if (width == 0 || height == 0)
+        return 0;
+
+    for (uint8_t i = 0; i < width; i++) {
+        data[i] = pattern->columns[(x + i) % 8];
+    }
+
+    uint8_t last = y + height - 1;
+    for (uint8_t page = y / 8; page <= last / 8; page++) {
+        uint8_t mask = page_mask(page, y, last);
+        if (mask == 0xFF)
+            lcd_write_run(self, page, x, data, width);
+        else if (lcd_merge_run(self, page, x, data, width, mask) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Bits of the page that lie within lines first..last. */
+static uint8_t page_mask(uint8_t page, uint8_t first, uint8_t last) {
+    uint8_t top = (page == first / 8) ? first % 8 : 0;
+    uint8_t bottom = (page == last / 8) ? last % 8 : 7;
+
+    return (0xFF << top) & (0xFF >> (7 - bottom));
+}
+
+static uint8_t clip(uint8_t start, uint8_t length, uint8_t limit) {
+    if (start >= limit)
+        return 0;
+    return (length > limit - start) ? limit - start : length;
+}
@@ -0,0 +1,33 @@
+#ifndef LCD_DRAW_H_
+#define LCD_DRAW_H_
+
+#include "lcd.h"
+
+/*
+ * 8x8 tile for lcd_fill_rect(): 8 page-major column bytes, LSB on top. Tiles are
+ * anchored to the screen grid, so neighbouring fills line up.
+ */
+struct lcd_pattern {
+    uint8_t columns[8];
+};
+
+extern const struct lcd_pattern lcd_pattern_clear;
+extern const struct lcd_pattern lcd_pattern_solid;
+extern const struct lcd_pattern lcd_pattern_checker;
+extern const struct lcd_pattern lcd_pattern_stipple;
+extern const struct lcd_pattern lcd_pattern_hatch;
+
+/*
+ * Drawing primitives on the page-major shadow (or the panel itself without one), mode
+ * is one of enum lcd_draw_modes. Everything is clipped to the screen and only the
+ * columns whose bytes change are marked dirty; lcd_flush() sends them.
+ */
+void lcd_draw_pixel(struct lcd *self, uint8_t x, uint8_t y, uint8_t mode);
+void lcd_draw_hline(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t mode);
+void lcd_draw_vline(struct lcd *self, uint8_t x, uint8_t y, uint8_t height, uint8_t mode);
+void lcd_draw_line(struct lcd *self, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t mode);
+void lcd_draw_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode);
+void lcd_draw_box(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t mode);
+int8_t lcd_fill_rect(struct lcd *self, uint8_t x, uint8_t y, uint8_t width, uint8_t height, const struct lcd_pattern *pattern);
+
+#endif
@@ -0,0 +1,193 @@
+#include "lcd_ebc.h"
+#include "lcd_bus.h"
+
+#include <MDR32FxQI_ebc.h>
+#include <MDR32FxQI_rst_clk.h>
+
+#include <stddef.h>
+
+static int8_t ebc_init(struct lcd *self);
+static void ebc_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count);
+static void ebc_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length);
+static uint8_t ebc_read_status(struct lcd *self, uint8_t part);
+static void ebc_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length);
+static void ebc_write(struct lcd *self, uint8_t part, volatile uint32_t *reg, const uint8_t *bytes, uint8_t count);
+#if LCD_DMA
+static void dma_task_init(DMA_CtrlDataTypeDef *task, const uint8_t *source, volatile uint32_t *destination, uint8_t length, uint8_t last);
+#endif
+
+const struct lcd_transport lcd_transport_ebc = {
+    .init = ebc_init,
+    .write_cmds = ebc_write_cmds,
+    .write_data_run = ebc_write_data_run,
+    .read_status = ebc_read_status,
+    .read_data_run = ebc_read_data_run
+};
+
+#if LCD_DMA
+static struct lcd *dma_owner;
+
+/*
+ * Sends the dirty runs of each chip as one memory scatter-gather DMA cycle to the EBC
+ * registers, so the calling task sleeps in lcd_dma_wait() while the bus is busy. There
+ * is no BUSY polling between bytes, the EBC wait states must cover the controller cycle.
+ */
+int8_t lcd_flush_dma(struct lcd *self) {
+    struct lcd_ebc *ebc = self->transport_data;
+
+    if (self->transport != &lcd_transport_ebc)
+        return -1;
+
+    RST_CLK_PCLKcmd(RST_CLK_PCLK_DMA, ENABLE);
+    NVIC_EnableIRQ(DMA_IRQn);
+
+    for (uint8_t half = 0; half < 2; half++) {
+        uint8_t pages = 0;
+        uint8_t tasks = 0;
+        uint32_t bytes = 0;
+
+        for (uint8_t i = 0; i < LCD_PAGES; i++) {
+            if (self->dirty[i][half].start < self->dirty[i][half].end)
+                pages++;
+        }
+        if (pages == 0)
+            continue;
+
+        for (uint8_t i = 0; i < LCD_PAGES; i++) {
+            struct lcd_dirty *dirty = &self->dirty[i][half];
+            if (dirty->start >= dirty->end)
+                continue;
+
+            /* The last data run ends the chain and raises the DMA interrupt. */
+            ebc->dma_commands[i][0] = 0xB8|i;
+            ebc->dma_commands[i][1] = 0x40|(dirty->start - half * LCD_PART_WIDTH);
+            dma_task_init(&ebc->dma_tasks[tasks], ebc->dma_commands[i], ebc->command, 2, 0);
+            dma_task_init(&ebc->dma_tasks[tasks + 1], &self->shadow.pages[i][dirty->start], ebc->data, dirty->end - dirty->start, tasks + 2 == pages * 2);
+            tasks += 2;
+            bytes += 2 + dirty->end - dirty->start;
+
+            dirty->start = LCD_WIDTH;
+            dirty->end = 0;
+        }
+
+        DMA_Channel_SG_InitTypeDef sg;
+        DMA_SG_StructInit(&sg);
+        sg.DMA_SG_TaskArray = ebc->dma_tasks;
+        sg.DMA_SG_TaskNumber = tasks;
+
+        lcd_bus_wait_ready(self, half ? LCD_PART_RIGHT : LCD_PART_LEFT);
+        lcd_bus_select(self, half ? LCD_PART_RIGHT : LCD_PART_LEFT);
+
+        dma_owner = self;
+        ebc->dma_busy = 1;
+        DMA_SG_Init(LCD_DMA_CHANNEL, &sg);
+        DMA_Request(LCD_DMA_CHANNEL);
+        while (ebc->dma_busy) {
+            lcd_dma_wait(self);
+        }
+
+        self->bytes_sent += bytes;
+    }
+    return 0;
+}
+
+/* To be called from DMA_IRQHandler, the interrupt is shared by all DMA channels. */
+void lcd_dma_irq_handler(void) {
+    struct lcd *self = dma_owner;
+
+    if (self == NULL || DMA_GetFlagStatus(LCD_DMA_CHANNEL, DMA_FLAG_CHNL_ENA) == SET)
+        return;
+
+    dma_owner = NULL;
+    ((struct lcd_ebc *)self->transport_data)->dma_busy = 0;
+    lcd_dma_done(self);
+}
+
+__attribute__ ((weak)) void lcd_dma_wait(struct lcd *self) {
+}
+
+__attribute__ ((weak)) void lcd_dma_done(struct lcd *self) {
+}
+
+static void dma_task_init(DMA_CtrlDataTypeDef *task, const uint8_t *source, volatile uint32_t *destination, uint8_t length, uint8_t last) {
+    DMA_CtrlDataInitTypeDef ctrl = {
+        .DMA_SourceBaseAddr = (uint32_t)source,
+        .DMA_DestBaseAddr = (uint32_t)destination,
+        .DMA_SourceIncSize = DMA_SourceIncByte,
+        .DMA_DestIncSize = DMA_DestIncNo,
+        .DMA_MemoryDataSize = DMA_MemoryDataSize_Byte,
+        .DMA_Mode = last ? DMA_Mode_AutoRequest : DMA_Mode_MemScatterAlt,
+        .DMA_CycleSize = length,
+        .DMA_NumContinuous = DMA_Transfers_1,
+        .DMA_SourceProtCtrl = DMA_SourcePrivileged,
+        .DMA_DestProtCtrl = DMA_DestPrivileged
+    };
+    DMA_CtrlDataInit(&ctrl, task);
+}
+#endif
+
+/*
+ * EBC pins must already be switched to their bus function by the board setup. The E
+ * strobe is the EBC access, at most 18 HCLK long: above 40 MHz it stays shorter than
+ * LCD_EBC_ACCESS_NS whatever the wait mode, so init fails and the board has to lower
+ * HCLK or use lcd_transport_gpio.
+ */
+static int8_t ebc_init(struct lcd *self) {
+    EBC_InitTypeDef ebc;
+    const struct lcd_ebc *config = self->transport_data;
+    uint32_t wait_states = EBC_CalcWaitStates(config->hclk_khz, LCD_EBC_ACCESS_NS);
+
+    if (config->hclk_khz == 0 || wait_states > EBC_WAIT_STATE_18HCLK)
+        return -1;
+
+    RST_CLK_PCLKcmd(RST_CLK_PCLK_EBC, ENABLE);
+
+    EBC_StructInit(&ebc);
+    ebc.EBC_Mode = EBC_MODE_RAM;
+    ebc.EBC_WaitState = wait_states;
+    EBC_Init(&ebc);
+
+    lcd_bus_reset(self);
+    return 0;
+}
+
+
+static void ebc_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count) {
+    ebc_write(self, part, ((struct lcd_ebc *)self->transport_data)->command, commands, count);
+}
+
+static void ebc_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length) {
+    ebc_write(self, part, ((struct lcd_ebc *)self->transport_data)->data, data, length);
+}
+
+static uint8_t ebc_read_status(struct lcd *self, uint8_t part) {
+    lcd_bus_select(self, part);
+    return *((struct lcd_ebc *)self->transport_data)->command;
+}
+
+/* The first read returns the controller output latch and is dropped. */
+static void ebc_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length) {
+    volatile uint32_t *reg = ((struct lcd_ebc *)self->transport_data)->data;
+
+    lcd_bus_wait_ready(self, part);
+    lcd_bus_select(self, part);
+    (void)*reg;
+
+    for (uint8_t i = 0; i < length; i++) {
+        if (self->wait_mode == LCD_WAIT_BUSY) {
+            lcd_bus_wait_ready(self, part);
+            lcd_bus_select(self, part);
+        }
+        data[i] = *reg;
+    }
+}
+
+static void ebc_write(struct lcd *self, uint8_t part, volatile uint32_t *reg, const uint8_t *bytes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (i == 0 || self->wait_mode == LCD_WAIT_BUSY) {
+            lcd_bus_wait_ready(self, part);
+            lcd_bus_select(self, part);
+        }
+        *reg = bytes[i];
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef LCD_EBC_H_
+#define LCD_EBC_H_
+
+#include "lcd.h"
+
+#if LCD_DMA
+#include <MDR32FxQI_dma.h>
+
+/* Software DMA channel used by lcd_flush_dma(). */
+#define LCD_DMA_CHANNEL     DMA_Channel_SW1
+#endif
+
+/*
+ * State of lcd_transport_ebc, pass it as lcd.transport_data. command and data are the
+ * register addresses in the EBC window (A0 wired to an address line), hclk_khz is the
+ * HCLK frequency the wait states are calculated from; at most 40000, see ebc_init().
+ */
+struct lcd_ebc {
+    volatile uint32_t *command;
+    volatile uint32_t *data;
+    uint32_t hclk_khz;
+
+#if LCD_DMA
+    /* lcd_flush_dma() scatter-gather chain for one chip: a page/column command pair
+     * and a data run per page. dma_busy is cleared from the DMA interrupt. */
+    DMA_CtrlDataTypeDef dma_tasks[LCD_PAGES * 2];
+    uint8_t dma_commands[LCD_PAGES][2];
+    volatile uint8_t dma_busy;
+#endif
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "lcd_font.h"
+
+static uint8_t glyph_index(const struct lcd_font *font, char c);
+static uint8_t glyph_width(const struct lcd_font *font, uint8_t index);
+static int8_t draw_row(struct lcd *self, uint8_t x, uint8_t line, const uint8_t *columns, uint8_t width, uint8_t mask);
+
+uint8_t lcd_text_width(const struct lcd_font *font, const char *text) {
+    uint16_t width = 0;
+
+    while (*text) {
+        width += glyph_width(font, glyph_index(font, *text++)) + font->spacing;
+    }
+    return (width > LCD_WIDTH) ? LCD_WIDTH : width;
+}
+
+/*
+ * Renders text into page rows of lcd_text_width() columns each, moved down by shift
+ * pixels, so a shifted text takes one page row more than the font. Returns the width,
+ * or 0 when the rows do not fit into size bytes.
+ */
+uint8_t lcd_font_render(const struct lcd_font *font, const char *text, uint8_t shift, uint8_t *buf, uint16_t size) {
+    uint8_t width = lcd_text_width(font, text);
+    uint8_t rows = font->pages + (shift ? 1 : 0);
+    uint8_t x = 0;
+
+    if (width == 0 || (uint16_t)rows * width > size)
+        return 0;
+
+    for (; *text && x < width; text++) {
+        uint8_t index = glyph_index(font, *text);
+        uint8_t glyph_w = glyph_width(font, index);
+        const uint8_t *glyph = &font->bitmap[font->offsets[index]];
+
+        for (uint8_t i = 0; i < glyph_w + font->spacing && x < width; i++, x++) {
+            uint8_t above = 0;
+            for (uint8_t row = 0; row < rows; row++) {
+                uint8_t column = (i < glyph_w && row < font->pages) ? glyph[row * glyph_w + i] : 0x00;
+                buf[row * width + x] = (column << shift) | (shift ? above >> (8 - shift) : 0);
+                above = column;
+            }
+        }
+    }
+    return width;
+}
+
+/*
+ * Draws text with its cell background cleared, clipped at the right and bottom edge.
+ * Returns the x after the text, or -1 when an unaligned row could not be merged
+ * (no shadow and a transport without read-back).
+ */
+int16_t lcd_draw_text(struct lcd *self, uint8_t x, uint8_t y, const struct lcd_font *font, const char *text) {
+    uint8_t columns[LCD_FONT_MAX_WIDTH];
+
+    for (; *text && x < LCD_WIDTH; text++) {
+        uint8_t index = glyph_index(font, *text);
+        uint8_t width = glyph_width(font, index);
+        const uint8_t *glyph = &font->bitmap[font->offsets[index]];
+        uint8_t cell = width + font->spacing;
+
+        if (cell > LCD_WIDTH - x)
+            cell = LCD_WIDTH - x;
+
+        for (uint8_t row = 0; row < font->pages; row++) {
+            uint8_t line = y + row * 8;
+            uint8_t bits = font->height - row * 8;
+            if (line >= LCD_HEIGHT)
+                break;
+
+            for (uint8_t i = 0; i < cell; i++) {
+                columns[i] = (i < width) ? glyph[row * width + i] : 0x00;
+            }
+            if (draw_row(self, x, line, columns, cell, (bits >= 8) ? 0xFF : (1 << bits) - 1) < 0)
+                return -1;
+        }
+        x += cell;
+    }
+    return x;
+}
+
+/* Characters missing from the font are drawn as '?' or, failing that, as the first glyph. */
+static uint8_t glyph_index(const struct lcd_font *font, char c) {
+    uint8_t code = c;
+
+    if (code < font->first || code >= font->first + font->count)
+        code = '?';
+    if (code < font->first || code >= font->first + font->count)
+        code = font->first;
+    return code - font->first;
+}
+
+static uint8_t glyph_width(const struct lcd_font *font, uint8_t index) {
+    return (font->offsets[index + 1] - font->offsets[index]) / font->pages;
+}
+
+/*
+ * One page row of glyph columns at display line `line`. A full row on a page boundary
+ * is copied as is; otherwise it is shifted into two pages and merged with what is there.
+ */
+static int8_t draw_row(struct lcd *self, uint8_t x, uint8_t line, const uint8_t *columns, uint8_t width, uint8_t mask) {
+    uint8_t page = line / 8;
+    uint8_t shift = line % 8;
+    uint8_t shifted[LCD_FONT_MAX_WIDTH];
+
+    if (shift == 0 && mask == 0xFF) {
+        lcd_write_run(self, page, x, columns, width);
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < width; i++) {
+        shifted[i] = columns[i] << shift;
+    }
+    if (lcd_merge_run(self, page, x, shifted, width, mask << shift) < 0)
+        return -1;
+    if (shift == 0 || page + 1 >= LCD_PAGES || (mask >> (8 - shift)) == 0)
+        return 0;
+
+    for (uint8_t i = 0; i < width; i++) {
+        shifted[i] = columns[i] >> (8 - shift);
+    }
+    return lcd_merge_run(self, page + 1, x, shifted, width, mask >> (8 - shift));
+}
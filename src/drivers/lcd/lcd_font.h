@@ -0,0 +1,27 @@
+#ifndef LCD_FONT_H_
+#define LCD_FONT_H_
+
+#include "lcd.h"
+
+/* Widest glyph including its spacing, tools/glyphgen.py enforces it. */
+#define LCD_FONT_MAX_WIDTH  16
+
+/*
+ * Bitmap font generated by tools/glyphgen.py. Glyph i takes the bytes from offsets[i]
+ * to offsets[i + 1]: pages rows of column bytes, top row first, LSB on top.
+ */
+struct lcd_font {
+    uint8_t first;      /* code of the first glyph */
+    uint8_t count;
+    uint8_t height;     /* pixels */
+    uint8_t pages;      /* page rows per glyph */
+    uint8_t spacing;    /* blank columns after each glyph */
+    const uint16_t *offsets;
+    const uint8_t *bitmap;
+};
+
+uint8_t lcd_text_width(const struct lcd_font *font, const char *text);
+uint8_t lcd_font_render(const struct lcd_font *font, const char *text, uint8_t shift, uint8_t *buf, uint16_t size);
+int16_t lcd_draw_text(struct lcd *self, uint8_t x, uint8_t y, const struct lcd_font *font, const char *text);
+
+#endif
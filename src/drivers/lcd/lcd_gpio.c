@@ -0,0 +1,207 @@
+#include "lcd_bus.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Direct port register access; host builds count it in the bus simulator. */
+#ifdef LCD_BUS_SIM
+#include "lcd_bus_sim.h"
+#define LCD_PORT_READ(port, reg)            lcd_bus_sim_read(&(port)->reg)
+#define LCD_PORT_WRITE(port, reg, value)    lcd_bus_sim_write(&(port)->reg, (value))
+#else
+#define LCD_PORT_READ(port, reg)            ((port)->reg)
+#define LCD_PORT_WRITE(port, reg, value)    ((port)->reg = (value))
+#endif
+
+static int8_t gpio_init(struct lcd *self);
+static void gpio_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count);
+static void gpio_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length);
+static uint8_t gpio_read_status(struct lcd *self, uint8_t part);
+static void gpio_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length);
+static void gpio_read(struct lcd *self, uint8_t part, uint8_t a0, uint8_t *bytes, uint8_t count);
+static void gpio_write(struct lcd *self, uint8_t part, uint8_t a0, const uint8_t *bytes, uint8_t count);
+static void bus_plan_init(struct lcd *self);
+static void write_bus(struct lcd *self, uint8_t value);
+static uint8_t read_bus(struct lcd *self);
+static void set_bus_direction(struct lcd *self, uint8_t output);
+static void set_a0(struct lcd *self, uint8_t a0);
+static void set_rw(struct lcd *self, uint8_t rw);
+
+const struct lcd_transport lcd_transport_gpio = {
+    .init = gpio_init,
+    .write_cmds = gpio_write_cmds,
+    .write_data_run = gpio_write_data_run,
+    .read_status = gpio_read_status,
+    .read_data_run = gpio_read_data_run
+};
+
+static int8_t gpio_init(struct lcd *self) {
+    bus_plan_init(self);
+    lcd_bus_reset(self);
+    return 0;
+}
+
+static void gpio_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count) {
+    gpio_write(self, part, 0, commands, count);
+}
+
+static void gpio_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length) {
+    gpio_write(self, part, 1, data, length);
+}
+
+static uint8_t gpio_read_status(struct lcd *self, uint8_t part) {
+    uint8_t status;
+
+    gpio_read(self, part, 0, &status, 1);
+    return status;
+}
+
+/* The controller answers the first data read with its output latch, only then with RAM. */
+static void gpio_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length) {
+    uint8_t dummy;
+
+    gpio_read(self, part, 1, &dummy, 1);
+    gpio_read(self, part, 1, data, length);
+}
+
+/* RW=1, the controller drives DB while E is high. Data reads wait for BUSY like writes do. */
+static void gpio_read(struct lcd *self, uint8_t part, uint8_t a0, uint8_t *bytes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (i == 0 || (a0 && self->wait_mode == LCD_WAIT_BUSY)) {
+            if (a0)
+                lcd_bus_wait_ready(self, part);
+            set_a0(self, a0);
+            lcd_bus_select(self, part);
+            set_bus_direction(self, 0);
+            set_rw(self, 1);
+        }
+
+        PORT_SetBits(self->e_port, self->e_pin);
+        lcd_delay(1);
+        bytes[i] = read_bus(self);
+        PORT_ResetBits(self->e_port, self->e_pin);
+        lcd_delay(1);
+    }
+
+    set_rw(self, 0);
+    set_bus_direction(self, 1);
+    self->latch.data_valid = 0;
+}
+
+/*
+ * Only the lines that differ from the latched state are driven: a batch to the same chip
+ * and register as the previous one starts without any control pin writes, and a repeated
+ * data byte is a bare E pulse. E stays low for a delay after every pulse, since then
+ * nothing else may lie between two of them.
+ */
+static void gpio_write(struct lcd *self, uint8_t part, uint8_t a0, const uint8_t *bytes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (i == 0 || self->wait_mode == LCD_WAIT_BUSY) {
+            lcd_bus_wait_ready(self, part);
+            set_a0(self, a0);
+            set_rw(self, 0);
+            lcd_bus_select(self, part);
+        }
+
+        if (!self->latch.data_valid || self->latch.data != bytes[i]) {
+            write_bus(self, bytes[i]);
+            self->latch.data = bytes[i];
+            self->latch.data_valid = 1;
+        }
+
+        PORT_SetBits(self->e_port, self->e_pin);
+        lcd_delay(1);
+        PORT_ResetBits(self->e_port, self->e_pin);
+        lcd_delay(1);
+    }
+}
+
+static void bus_plan_init(struct lcd *self) {
+    self->bus_ports = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        struct lcd_bus_port *bus = NULL;
+        for (uint8_t j = 0; j < self->bus_ports; j++) {
+            if (self->bus[j].port == self->db_ports[i])
+                bus = &self->bus[j];
+        }
+
+        if (bus == NULL) {
+            if (self->bus_ports == LCD_BUS_PORTS_MAX) {
+                self->bus_ports = 0;
+                return;
+            }
+            bus = &self->bus[self->bus_ports++];
+            memset(bus, 0, sizeof(*bus));
+            bus->port = self->db_ports[i];
+            bus->keep = ~JTAG_PINS(bus->port);
+        }
+
+        bus->pins |= self->db_pins[i];
+        bus->keep &= ~self->db_pins[i];
+        for (uint8_t nibble = 0; nibble < 16; nibble++) {
+            if (nibble & (1 << (i & 0x03))) {
+                if (i < 4)
+                    bus->lo[nibble] |= self->db_pins[i];
+                else
+                    bus->hi[nibble] |= self->db_pins[i];
+            }
+        }
+    }
+}
+
+/* One read-modify-write of RXTX per port instead of one per DB pin. */
+static void write_bus(struct lcd *self, uint8_t value) {
+    if (self->bus_ports == 0) {
+        for (int i = 0; i < 8; i++) {
+            (value>>i & 0x01) ? PORT_SetBits(self->db_ports[i], self->db_pins[i]) : PORT_ResetBits(self->db_ports[i], self->db_pins[i]);
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < self->bus_ports; i++) {
+        struct lcd_bus_port *bus = &self->bus[i];
+        LCD_PORT_WRITE(bus->port, RXTX, (LCD_PORT_READ(bus->port, RXTX) & bus->keep) | bus->lo[value & 0x0F] | bus->hi[value >> 4]);
+    }
+}
+
+static uint8_t read_bus(struct lcd *self) {
+    uint8_t value = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        if (LCD_PORT_READ(self->db_ports[i], RXTX) & self->db_pins[i])
+            value |= 1 << i;
+    }
+    return value;
+}
+
+static void set_bus_direction(struct lcd *self, uint8_t output) {
+    if (self->bus_ports == 0) {
+        for (uint8_t i = 0; i < 8; i++) {
+            uint32_t oe = LCD_PORT_READ(self->db_ports[i], OE);
+            LCD_PORT_WRITE(self->db_ports[i], OE, output ? (oe | self->db_pins[i]) : (oe & ~self->db_pins[i]));
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < self->bus_ports; i++) {
+        uint32_t oe = LCD_PORT_READ(self->bus[i].port, OE);
+        LCD_PORT_WRITE(self->bus[i].port, OE, output ? (oe | self->bus[i].pins) : (oe & ~self->bus[i].pins));
+    }
+}
+
+static void set_a0(struct lcd *self, uint8_t a0) {
+    if (self->latch.a0 == a0)
+        return;
+
+    self->latch.a0 = a0;
+    a0 ? PORT_SetBits(self->a0_port, self->a0_pin) : PORT_ResetBits(self->a0_port, self->a0_pin);
+}
+
+static void set_rw(struct lcd *self, uint8_t rw) {
+    if (self->latch.rw == rw)
+        return;
+
+    self->latch.rw = rw;
+    rw ? PORT_SetBits(self->rw_port, self->rw_pin) : PORT_ResetBits(self->rw_port, self->rw_pin);
+}
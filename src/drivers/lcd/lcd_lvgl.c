@@ -0,0 +1,88 @@
+#include "lcd_lvgl.h"
+
+static void lvgl_rounder(lv_disp_drv_t *drv, lv_area_t *area);
+static void lvgl_set_px(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y, lv_color_t color, lv_opa_t opa);
+static void lvgl_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+static void lvgl_wait(lv_disp_drv_t *drv);
+
+lv_disp_t *lcd_lvgl_init(struct lcd_lvgl *self, struct lcd *lcd) {
+    self->lcd = lcd;
+
+    /* LVGL sizes the buffer in pixels. */
+    lv_disp_draw_buf_init(&self->draw_buf, self->buf[0], self->buf[1], sizeof(self->buf[0]) * 8);
+    self->pending = 0;
+
+    lv_disp_drv_init(&self->drv);
+    self->drv.hor_res = LCD_WIDTH;
+    self->drv.ver_res = LCD_HEIGHT;
+    self->drv.draw_buf = &self->draw_buf;
+    self->drv.rounder_cb = lvgl_rounder;
+    self->drv.set_px_cb = lvgl_set_px;
+    self->drv.flush_cb = lvgl_flush;
+    self->drv.wait_cb = lvgl_wait;
+    self->drv.user_data = self;
+    self->disp = lv_disp_drv_register(&self->drv);
+    return self->disp;
+}
+
+/* Areas always cover whole pages, so a flush never has to merge with what the panel shows. */
+static void lvgl_rounder(lv_disp_drv_t *drv, lv_area_t *area) {
+    area->y1 &= ~0x07;
+    area->y2 |= 0x07;
+}
+
+/* x and y are relative to the area being rendered, whose top edge is page aligned. */
+static void lvgl_set_px(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y, lv_color_t color, lv_opa_t opa) {
+    uint8_t *column = &buf[(y >> 3) * buf_w + x];
+
+    if (lv_color_brightness(color) < 128)
+        *column |= 1 << (y & 0x07);
+    else
+        *column &= ~(1 << (y & 0x07));
+}
+
+static void lvgl_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    struct lcd_lvgl *self = drv->user_data;
+
+    self->area = *area;
+    self->data = (const uint8_t *)color_p;
+    self->pending = 1;
+    lcd_lvgl_flush_start(self);
+}
+
+static void lvgl_wait(lv_disp_drv_t *drv) {
+    lcd_lvgl_wait(drv->user_data);
+}
+
+/*
+ * Sends the area handed over by flush_cb, through DMA with LCD_DMA on the EBC transport,
+ * and gives the buffer back to LVGL. Returns -1 when there is nothing to send.
+ */
+int8_t lcd_lvgl_flush_pending(struct lcd_lvgl *self) {
+    if (!self->pending)
+        return -1;
+
+    const uint8_t *data = self->data;
+    uint8_t width = lv_area_get_width(&self->area);
+    for (uint8_t page = self->area.y1 / 8; page <= self->area.y2 / 8; page++) {
+        lcd_write_run(self->lcd, page, self->area.x1, data, width);
+        data += width;
+    }
+#if LCD_DMA
+    if (lcd_flush_dma(self->lcd) < 0)
+        lcd_flush(self->lcd);
+#elif LCD_SHADOW
+    lcd_flush(self->lcd);
+#endif
+
+    self->pending = 0;
+    lv_disp_flush_ready(&self->drv);
+    return 0;
+}
+
+__attribute__ ((weak)) void lcd_lvgl_flush_start(struct lcd_lvgl *self) {
+    lcd_lvgl_flush_pending(self);
+}
+
+__attribute__ ((weak)) void lcd_lvgl_wait(struct lcd_lvgl *self) {
+}
@@ -0,0 +1,48 @@
+#ifndef LCD_LVGL_H_
+#define LCD_LVGL_H_
+
+#include "lcd.h"
+
+#include <lvgl.h>
+
+/* The port is written against the v8 display driver API, see the branch in .gitmodules. */
+#if LVGL_VERSION_MAJOR != 8
+#error "lcd_lvgl needs LVGL v8 (release/v8.3)"
+#endif
+
+/* Height of one partial draw buffer in pages; 2 pages are 256 bytes. */
+#ifndef LCD_LVGL_BUF_PAGES
+#define LCD_LVGL_BUF_PAGES  2
+#endif
+
+/*
+ * LVGL v8 display for the panel. LVGL renders through set_px_cb straight into the
+ * page-major layout of the panel, so a draw buffer holds 8 pixels per byte and a
+ * flushed area is a stack of page rows, each as wide as the area.
+ *
+ * There are two draw buffers: flush_cb only hands the area over through
+ * lcd_lvgl_flush_start() and LVGL goes on rendering into the other buffer, while
+ * lcd_lvgl_flush_pending() sends the area and returns its buffer to LVGL.
+ */
+struct lcd_lvgl {
+    struct lcd *lcd;
+    uint8_t buf[2][LCD_LVGL_BUF_PAGES * LCD_WIDTH];
+    lv_disp_draw_buf_t draw_buf;
+    lv_disp_drv_t drv;
+    lv_disp_t *disp;
+
+    lv_area_t area;
+    const uint8_t *data;
+    volatile uint8_t pending;
+};
+
+/* Called from flush_cb; the default sends the area right away. */
+void lcd_lvgl_flush_start(struct lcd_lvgl *self);
+/* Called by LVGL while it waits for a draw buffer; the default spins. */
+void lcd_lvgl_wait(struct lcd_lvgl *self);
+
+/* lv_init() must have been called and the panel set up with lcd_init(). */
+lv_disp_t *lcd_lvgl_init(struct lcd_lvgl *self, struct lcd *lcd);
+int8_t lcd_lvgl_flush_pending(struct lcd_lvgl *self);
+
+#endif
@@ -0,0 +1,59 @@
+#include "lcd_rle.h"
+
+#include <string.h>
+
+static void write_stream(struct lcd *self, uint16_t *offset, const uint8_t *data, uint8_t length, uint8_t repeat);
+
+/*
+ * Decodes the image straight into lcd_write_run() without a frame buffer: literals are
+ * passed on from flash, runs from a chip-wide buffer of the repeated byte. Without the
+ * shadow a run therefore reaches the bus as one data run of equal bytes, which the GPIO
+ * transport sends as bare E pulses. Returns -1 for a malformed or short stream, the
+ * part decoded so far is drawn anyway.
+ */
+int8_t lcd_show_rle(struct lcd *self, const struct lcd_rle_image *image) {
+    const uint8_t *data = image->data;
+    const uint8_t *end = data + image->size;
+    uint16_t offset = 0;
+    uint8_t fill[LCD_PART_WIDTH];
+    int8_t result = 0;
+
+    while (data < end) {
+        uint8_t control = *data++;
+        uint8_t length = (control & 0x80) ? (control & 0x7F) + LCD_RLE_RUN_MIN : control + 1;
+
+        if (offset + length > LCD_PAGES * LCD_WIDTH || end - data < ((control & 0x80) ? 1 : length)) {
+            result = -1;
+            break;
+        }
+        if (control & 0x80) {
+            memset(fill, *data++, sizeof(fill));
+            write_stream(self, &offset, fill, length, 1);
+        } else {
+            write_stream(self, &offset, data, length, 0);
+            data += length;
+        }
+    }
+
+#if LCD_SHADOW
+    lcd_flush(self);
+#endif
+    return (offset == LCD_PAGES * LCD_WIDTH) ? result : -1;
+}
+
+/* Splits at page ends, and runs at chip ends since fill holds one chip row. */
+static void write_stream(struct lcd *self, uint16_t *offset, const uint8_t *data, uint8_t length, uint8_t repeat) {
+    while (length > 0) {
+        uint8_t column = *offset % LCD_WIDTH;
+        uint8_t run = repeat ? LCD_PART_WIDTH - column % LCD_PART_WIDTH : LCD_WIDTH - column;
+
+        if (run > length)
+            run = length;
+        lcd_write_run(self, *offset / LCD_WIDTH, column, data, run);
+
+        *offset += run;
+        length -= run;
+        if (!repeat)
+            data += run;
+    }
+}
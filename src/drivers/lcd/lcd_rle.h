@@ -0,0 +1,20 @@
+#ifndef LCD_RLE_H_
+#define LCD_RLE_H_
+
+#include "lcd.h"
+
+/* Shortest run the format encodes; shorter repeats are cheaper as literals. */
+#define LCD_RLE_RUN_MIN     3
+
+/*
+ * Full screen image compressed by tools/rlegen.py, see there for the format. Mostly
+ * blank screens shrink to a few dozen bytes instead of a 1 KB raw frame.
+ */
+struct lcd_rle_image {
+    uint16_t size;
+    const uint8_t *data;
+};
+
+int8_t lcd_show_rle(struct lcd *self, const struct lcd_rle_image *image);
+
+#endif
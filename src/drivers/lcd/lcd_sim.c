@@ -0,0 +1,118 @@
+#include "lcd_sim.h"
+
+#include <string.h>
+
+static int8_t sim_init(struct lcd *self);
+static void sim_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count);
+static void sim_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length);
+static uint8_t sim_read_status(struct lcd *self, uint8_t part);
+static void sim_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length);
+static uint8_t part_selects(uint8_t part, uint8_t chip);
+
+const struct lcd_transport lcd_transport_sim = {
+    .init = sim_init,
+    .write_cmds = sim_write_cmds,
+    .write_data_run = sim_write_data_run,
+    .read_status = sim_read_status,
+    .read_data_run = sim_read_data_run
+};
+
+/* Display row y shows RAM line (y + start line) of the chip owning column x. */
+uint8_t lcd_sim_pixel(const struct lcd_sim *sim, uint8_t x, uint8_t y) {
+    uint8_t chip = x / LCD_PART_WIDTH;
+    uint8_t line = (y + sim->start_line[chip]) % LCD_HEIGHT;
+
+    if (!sim->display_on[chip])
+        return 0;
+    return (sim->ram[chip][line / 8][x % LCD_PART_WIDTH] >> (line % 8)) & 0x01;
+}
+
+/* Power-on state of the controller; the RAM content is left as garbage on purpose. */
+void lcd_sim_reset(struct lcd_sim *sim) {
+    memset(sim->ram, 0xA5, sizeof(sim->ram));
+    memset(sim->page, 0, sizeof(sim->page));
+    memset(sim->column, 0, sizeof(sim->column));
+    memset(sim->start_line, 0, sizeof(sim->start_line));
+    memset(sim->display_on, 0, sizeof(sim->display_on));
+    memset(sim->latch, 0, sizeof(sim->latch));
+}
+
+void lcd_sim_command(struct lcd_sim *sim, uint8_t chip, uint8_t command) {
+    if ((command & 0xFE) == 0x3E)
+        sim->display_on[chip] = command & 0x01;
+    else if ((command & 0xC0) == 0x40)
+        sim->column[chip] = command & 0x3F;
+    else if ((command & 0xF8) == 0xB8)
+        sim->page[chip] = command & 0x07;
+    else if ((command & 0xC0) == 0xC0)
+        sim->start_line[chip] = command & 0x3F;
+}
+
+void lcd_sim_write(struct lcd_sim *sim, uint8_t chip, uint8_t data) {
+    sim->ram[chip][sim->page[chip]][sim->column[chip]] = data;
+    sim->column[chip] = (sim->column[chip] + 1) % LCD_PART_WIDTH;
+}
+
+/* Models the read pipeline: a read returns the output latch and reloads it from RAM. */
+uint8_t lcd_sim_read(struct lcd_sim *sim, uint8_t chip) {
+    uint8_t data = sim->latch[chip];
+
+    sim->latch[chip] = sim->ram[chip][sim->page[chip]][sim->column[chip]];
+    sim->column[chip] = (sim->column[chip] + 1) % LCD_PART_WIDTH;
+    return data;
+}
+
+/* BUSY and RESET are never set, bit 5 reports the display switched off. */
+uint8_t lcd_sim_status(const struct lcd_sim *sim, uint8_t chip) {
+    return sim->display_on[chip] ? 0x00 : 0x20;
+}
+
+static int8_t sim_init(struct lcd *self) {
+    lcd_sim_reset(self->transport_data);
+    return 0;
+}
+
+static void sim_write_cmds(struct lcd *self, uint8_t part, const uint8_t *commands, uint8_t count) {
+    struct lcd_sim *sim = self->transport_data;
+
+    for (uint8_t i = 0; i < count; i++) {
+        sim->commands++;
+        for (uint8_t chip = 0; chip < 2; chip++) {
+            if (part_selects(part, chip))
+                lcd_sim_command(sim, chip, commands[i]);
+        }
+    }
+}
+
+static void sim_write_data_run(struct lcd *self, uint8_t part, const uint8_t *data, uint8_t length) {
+    struct lcd_sim *sim = self->transport_data;
+
+    for (uint8_t i = 0; i < length; i++) {
+        sim->data++;
+        for (uint8_t chip = 0; chip < 2; chip++) {
+            if (part_selects(part, chip))
+                lcd_sim_write(sim, chip, data[i]);
+        }
+    }
+}
+
+static uint8_t sim_read_status(struct lcd *self, uint8_t part) {
+    return lcd_sim_status(self->transport_data, part == LCD_PART_LEFT ? 0 : 1);
+}
+
+/* The first read is the dummy one that loads the latch from the addressed column. */
+static void sim_read_data_run(struct lcd *self, uint8_t part, uint8_t *data, uint8_t length) {
+    struct lcd_sim *sim = self->transport_data;
+    uint8_t chip = part == LCD_PART_LEFT ? 0 : 1;
+
+    sim->reads++;
+    lcd_sim_read(sim, chip);
+    for (uint8_t i = 0; i < length; i++) {
+        sim->reads++;
+        data[i] = lcd_sim_read(sim, chip);
+    }
+}
+
+static uint8_t part_selects(uint8_t part, uint8_t chip) {
+    return part == LCD_PART_BOTH || part == (chip ? LCD_PART_RIGHT : LCD_PART_LEFT);
+}
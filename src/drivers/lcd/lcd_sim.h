@@ -0,0 +1,34 @@
+#ifndef LCD_SIM_H_
+#define LCD_SIM_H_
+
+#include "lcd.h"
+
+/*
+ * Virtual panel for host builds: decodes the command/data stream of both chips into
+ * their display RAM. Pass it as lcd.transport_data together with lcd_transport_sim.
+ */
+struct lcd_sim {
+    uint8_t ram[2][LCD_PAGES][LCD_PART_WIDTH];  /* [0] is the left chip */
+    uint8_t page[2];
+    uint8_t column[2];
+    uint8_t start_line[2];
+    uint8_t display_on[2];
+    uint8_t latch[2];       /* output register, a data read returns it and reloads it */
+
+    uint32_t commands;
+    uint32_t data;
+    uint32_t reads;
+};
+
+extern const struct lcd_transport lcd_transport_sim;
+
+uint8_t lcd_sim_pixel(const struct lcd_sim *sim, uint8_t x, uint8_t y);
+
+/* One bus cycle of chip 0 (left) or 1 (right), for simulators working below the transport. */
+void lcd_sim_reset(struct lcd_sim *sim);
+void lcd_sim_command(struct lcd_sim *sim, uint8_t chip, uint8_t command);
+void lcd_sim_write(struct lcd_sim *sim, uint8_t chip, uint8_t data);
+uint8_t lcd_sim_read(struct lcd_sim *sim, uint8_t chip);
+uint8_t lcd_sim_status(const struct lcd_sim *sim, uint8_t chip);
+
+#endif
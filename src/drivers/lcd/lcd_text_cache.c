@@ -0,0 +1,95 @@
+#include "lcd_text_cache.h"
+
+#include <string.h>
+
+static struct lcd_text_cache_entry *lookup(struct lcd_text_cache *cache, const struct lcd_font *font, const char *text, uint8_t shift);
+static struct lcd_text_cache_entry *evict(struct lcd_text_cache *cache);
+static uint8_t row_mask(const struct lcd_font *font, uint8_t shift, uint8_t row);
+
+void lcd_text_cache_init(struct lcd_text_cache *cache) {
+    memset(cache, 0, sizeof(*cache));
+}
+
+/*
+ * lcd_draw_text() through the cache: a hit copies the stored page rows into place,
+ * full rows with lcd_write_run() and the partly covered top and bottom rows with
+ * lcd_merge_run().
+ */
+int16_t lcd_draw_text_cached(struct lcd *self, struct lcd_text_cache *cache, uint8_t x, uint8_t y, const struct lcd_font *font, const char *text) {
+    uint8_t shift = y % 8;
+    struct lcd_text_cache_entry *entry;
+
+    if (x >= LCD_WIDTH)
+        return x;
+    if (strlen(text) >= LCD_TEXT_CACHE_TEXT) {
+        cache->bypasses++;
+        return lcd_draw_text(self, x, y, font, text);
+    }
+
+    entry = lookup(cache, font, text, shift);
+    if (entry != NULL) {
+        cache->hits++;
+    } else {
+        entry = evict(cache);
+        uint8_t width = lcd_font_render(font, text, shift, cache->arena[entry - cache->entries], LCD_TEXT_CACHE_SLOT);
+        if (width == 0) {
+            cache->bypasses++;
+            return lcd_draw_text(self, x, y, font, text);
+        }
+
+        cache->misses++;
+        entry->font = font;
+        strcpy(entry->text, text);
+        entry->shift = shift;
+        entry->width = width;
+    }
+    entry->used = ++cache->clock;
+
+    const uint8_t *rows = cache->arena[entry - cache->entries];
+    uint8_t width = (entry->width > LCD_WIDTH - x) ? LCD_WIDTH - x : entry->width;
+    uint8_t count = font->pages + (shift ? 1 : 0);
+
+    for (uint8_t row = 0; row < count && y / 8 + row < LCD_PAGES; row++) {
+        uint8_t mask = row_mask(font, shift, row);
+        if (mask == 0x00)
+            continue;
+        if (mask == 0xFF)
+            lcd_write_run(self, y / 8 + row, x, &rows[row * entry->width], width);
+        else if (lcd_merge_run(self, y / 8 + row, x, &rows[row * entry->width], width, mask) < 0)
+            return -1;
+    }
+    return x + width;
+}
+
+static struct lcd_text_cache_entry *lookup(struct lcd_text_cache *cache, const struct lcd_font *font, const char *text, uint8_t shift) {
+    for (uint8_t i = 0; i < LCD_TEXT_CACHE_ENTRIES; i++) {
+        struct lcd_text_cache_entry *entry = &cache->entries[i];
+        if (entry->used && entry->font == font && entry->shift == shift && strcmp(entry->text, text) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+/* A free entry if there is one, otherwise the least recently drawn one. */
+static struct lcd_text_cache_entry *evict(struct lcd_text_cache *cache) {
+    struct lcd_text_cache_entry *oldest = &cache->entries[0];
+
+    for (uint8_t i = 1; i < LCD_TEXT_CACHE_ENTRIES && oldest->used; i++) {
+        if (cache->entries[i].used < oldest->used)
+            oldest = &cache->entries[i];
+    }
+    oldest->used = 0;
+    return oldest;
+}
+
+/* Bits of page row `row` covered by the text cell, which spans lines shift..shift+height-1. */
+static uint8_t row_mask(const struct lcd_font *font, uint8_t shift, uint8_t row) {
+    int16_t top = shift - row * 8;
+    int16_t bottom = shift + font->height - row * 8;
+
+    if (top < 0)
+        top = 0;
+    if (bottom > 8)
+        bottom = 8;
+    return (0xFF >> (8 - bottom)) & (0xFF << top);
+}
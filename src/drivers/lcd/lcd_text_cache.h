@@ -0,0 +1,47 @@
+#ifndef LCD_TEXT_CACHE_H_
+#define LCD_TEXT_CACHE_H_
+
+#include "lcd_font.h"
+
+#ifndef LCD_TEXT_CACHE_ENTRIES
+#define LCD_TEXT_CACHE_ENTRIES  8
+#endif
+
+/* Arena bytes per entry: a 64 column text shifted off the page grid (two page rows). */
+#ifndef LCD_TEXT_CACHE_SLOT
+#define LCD_TEXT_CACHE_SLOT     128
+#endif
+
+/* Longest cached text including the terminating zero. */
+#ifndef LCD_TEXT_CACHE_TEXT
+#define LCD_TEXT_CACHE_TEXT     16
+#endif
+
+/*
+ * Rendered page rows of one text. The vertical shift (y % 8) is part of the key because
+ * page-major rows differ per shift, while moving text sideways needs no re-render.
+ */
+struct lcd_text_cache_entry {
+    const struct lcd_font *font;
+    char text[LCD_TEXT_CACHE_TEXT];
+    uint8_t shift;
+    uint8_t width;
+    uint32_t used;      /* LRU stamp, 0 for a free entry */
+};
+
+/* Fixed arena, one slot per entry: no heap and no fragmentation. */
+struct lcd_text_cache {
+    struct lcd_text_cache_entry entries[LCD_TEXT_CACHE_ENTRIES];
+    uint8_t arena[LCD_TEXT_CACHE_ENTRIES][LCD_TEXT_CACHE_SLOT];
+    uint32_t clock;
+
+    /* Texts that are too long or too wide for a slot are drawn uncached as bypasses. */
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t bypasses;
+};
+
+void lcd_text_cache_init(struct lcd_text_cache *cache);
+int16_t lcd_draw_text_cached(struct lcd *self, struct lcd_text_cache *cache, uint8_t x, uint8_t y, const struct lcd_font *font, const char *text);
+
+#endif
@@ -19,3 +19,48 @@ void led_off(struct led *self)
     PORT_ResetBits(self->port, self->pin);
 }
 
+
+void led_engine_init(struct led_engine *self)
+{
+    self->pins = 0;
+    self->ticks = 0;
+    for (uint8_t i = 0; i < self->count; i++) {
+        self->pins |= self->channels[i].pin;
+    }
+}
+
+void led_engine_set(struct led_engine *self, uint8_t channel, const struct led_pattern *pattern)
+{
+    if (channel < self->count)
+        self->channels[channel].pattern = *pattern;
+}
+
+/*
+ * Works out the level of every LED and writes them with one RXTX update; pins of the
+ * port that are not LEDs keep their level. When this runs from an interrupt that lands
+ * inside a task's read-modify-write of the same port, the task writes the old LED levels
+ * back and the change shows one tick late.
+ */
+void led_engine_tick(struct led_engine *self)
+{
+    uint32_t levels = 0;
+
+    for (uint8_t i = 0; i < self->count; i++) {
+        const struct led_pattern *pattern = &self->channels[i].pattern;
+        if (pattern->period == 0)
+            continue;
+
+        uint16_t phase = self->ticks % pattern->period;
+        uint8_t lit;
+        if (pattern->code == 0)
+            lit = phase < pattern->on;
+        else
+            lit = pattern->on > 0 && phase < 2 * pattern->on * pattern->code && (phase / pattern->on) % 2 == 0;
+
+        if (lit)
+            levels |= self->channels[i].pin;
+    }
+
+    self->port->RXTX = (self->port->RXTX & ~self->pins & ~JTAG_PINS(self->port)) | levels;
+    self->ticks++;
+}
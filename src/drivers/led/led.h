@@ -9,8 +9,37 @@ struct led {
     uint8_t state;
 };
 
+/*
+ * Blink pattern in engine ticks. With code 0 the LED is lit for the first on ticks of
+ * every period (the duty cycle); otherwise it flashes code times, on ticks lit and on
+ * ticks dark each, and stays dark for the rest of the period.
+ */
+struct led_pattern {
+    uint16_t period;    /* 0 keeps the LED dark */
+    uint16_t on;
+    uint8_t code;
+};
+
+struct led_channel {
+    uint32_t pin;
+    struct led_pattern pattern;
+};
+
+/* All LEDs on one port, updated together from a periodic tick. */
+struct led_engine {
+    MDR_PORT_TypeDef *port;
+    struct led_channel *channels;
+    uint8_t count;
+    uint32_t pins;      /* pins of all channels, set by led_engine_init() */
+    uint32_t ticks;
+};
+
 void led_toggle(struct led *self);
 void led_on(struct led *self);
 void led_off(struct led *self);
 
+void led_engine_init(struct led_engine *self);
+void led_engine_set(struct led_engine *self, uint8_t channel, const struct led_pattern *pattern);
+void led_engine_tick(struct led_engine *self);
+
 #endif
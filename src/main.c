@@ -6,18 +6,13 @@
 #include <MDR32FxQI_port.h>
 #include <MDR32FxQI_utils.h>
 
-void led0_task(void *pv_arg);
-void led1_task(void *pv_arg);
-void led2_task(void *pv_arg);
-void led3_task(void *pv_arg);
-
 int main(void)
 {
     bsp_init();
 
-    threads_init();
-
-    kernel_start();
+    /* Stays in the loop below for the debugger if a task does not fit into the heap. */
+    if (threads_init() == 0)
+        kernel_start();
 
     while (1) {
         ;
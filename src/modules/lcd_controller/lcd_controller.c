@@ -1,48 +1,337 @@
 #include "lcd_controller.h"
 #include "drivers/lcd/lcd.h"
+#include "drivers/lcd/lcd_draw.h"
+#include "drivers/lcd/lcd_lvgl.h"
 #include "MDR32FxQI_utils.h"
 
 #include <FreeRTOS.h>
 #include <task.h>
+#include <queue.h>
+
+#include <string.h>
+
+static int8_t check_command(const struct lcd_command *command);
+static uint8_t run_commands(void);
+static void run_command(struct lcd_command *command);
+static void flush(void);
+static void lcd0_setup(void);
+static uint32_t flush_start(void);
+static void flush_done(uint32_t start);
 
 void DELAY_PROGRAM_WaitLoopsAsm(uint32_t Loops) {}
 
+/*
+ * Task notification indexes, one count each so a wait for one never eats the other:
+ * new work for the task, and a transfer the task waits for has finished.
+ */
+#define NOTIFY_WORK 0
+#define NOTIFY_DONE 1
+
+static TaskHandle_t lcd_controller_handle;
+static TaskHandle_t lcd_flush_handle;
+static QueueHandle_t lcd_command_queue;
+static struct lcd_refresh_stats lcd_refresh;
+static uint16_t lcd_refresh_frames;
+
+/* Frame storage sits in the .framebuffer section of linker.ld. The section is neither
+ * loaded nor cleared at startup, lcd_flush_task() sets both objects up before use. */
+#define FRAMEBUFFER __attribute__ ((section(".framebuffer"), aligned(8)))
+
+static struct lcd lcd0 FRAMEBUFFER;
+static struct lcd_lvgl lcd0_lvgl FRAMEBUFFER;
+
+/* Before the scheduler starts, so any task may post from its first run on. */
+void lcd_controller_init(void) {
+    lcd_command_queue = xQueueCreate(LCD_COMMAND_QUEUE_LENGTH, sizeof(struct lcd_command));
+}
+
 int8_t lcd_delay(uint32_t us) {
     DELAY_WaitUs(us);
     return 0;
 }
 
-void lcd_controller_task(void *pv_arg)
+#if LCD_DMA
+void lcd_dma_wait(struct lcd *self) {
+    ulTaskNotifyTakeIndexed(NOTIFY_DONE, pdTRUE, portMAX_DELAY);
+}
+
+void lcd_dma_done(struct lcd *self) {
+    BaseType_t woken = pdFALSE;
+
+    vTaskNotifyGiveIndexedFromISR(lcd_flush_handle, NOTIFY_DONE, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+#endif
+
+/* LVGL time follows the kernel tick. */
+void vApplicationTickHook(void) {
+    lv_tick_inc(portTICK_PERIOD_MS);
+}
+
+/*
+ * Makes the LVGL task run its timers now, e.g. after an input event or a new value to
+ * show. Does nothing until the task runs, it starts with its timers due anyway.
+ */
+void lcd_controller_wake(void) {
+    if (lcd_controller_handle != NULL)
+        xTaskNotifyGiveIndexed(lcd_controller_handle, NOTIFY_WORK);
+}
+
+void lcd_controller_wake_from_isr(void) {
+    BaseType_t woken = pdFALSE;
+
+    if (lcd_controller_handle == NULL)
+        return;
+    vTaskNotifyGiveIndexedFromISR(lcd_controller_handle, NOTIFY_WORK, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/*
+ * Queues a drawing record for the flush task and wakes it. Never blocks: returns -1 when
+ * the queue is full, so a producer may drop or retry the update, or when the record
+ * cannot be drawn.
+ */
+int8_t lcd_controller_post(const struct lcd_command *command) {
+    if (check_command(command) < 0 || lcd_command_queue == NULL || xQueueSend(lcd_command_queue, command, 0) != pdTRUE)
+        return -1;
+    if (lcd_flush_handle != NULL)
+        xTaskNotifyGiveIndexed(lcd_flush_handle, NOTIFY_WORK);
+    return 0;
+}
+
+int8_t lcd_controller_post_from_isr(const struct lcd_command *command) {
+    BaseType_t woken = pdFALSE;
+
+    if (check_command(command) < 0 || lcd_command_queue == NULL || xQueueSendFromISR(lcd_command_queue, command, &woken) != pdTRUE)
+        return -1;
+    if (lcd_flush_handle != NULL)
+        vTaskNotifyGiveIndexedFromISR(lcd_flush_handle, NOTIFY_WORK, &woken);
+    portYIELD_FROM_ISR(woken);
+    return 0;
+}
+
+void lcd_controller_stats(struct lcd_refresh_stats *stats) {
+    taskENTER_CRITICAL();
+    *stats = lcd_refresh;
+    taskEXIT_CRITICAL();
+}
+
+void lcd_lvgl_flush_start(struct lcd_lvgl *self) {
+    xTaskNotifyGiveIndexed(lcd_flush_handle, NOTIFY_WORK);
+}
+
+/* LVGL calls it in a loop until its buffer is free, so a stale notification costs a turn. */
+void lcd_lvgl_wait(struct lcd_lvgl *self) {
+    ulTaskNotifyTakeIndexed(NOTIFY_DONE, pdTRUE, portMAX_DELAY);
+}
+
+/*
+ * Owns the panel bus: sets the panel up, sends the areas handed over by flush_cb and
+ * draws the queued commands. It runs above the LVGL task, so the panel is ready before
+ * LVGL renders.
+ *
+ * Commands are drawn into the shadow as they arrive, but the flush is held back for
+ * LCD_REFRESH_MERGE_MS after the first one, and until 1/LCD_REFRESH_MAX_FPS has passed
+ * since the last flush, so a burst of updates costs one pass over the bus. The task
+ * sleeps while nothing changes and wakes once a second only to close the FPS count.
+ */
+void lcd_flush_task(void *pv_arg)
 {
-    struct lcd lcd0 = {
-        .db_pins = {PORT_Pin_0, PORT_Pin_1, PORT_Pin_2, PORT_Pin_3, PORT_Pin_4, PORT_Pin_5, PORT_Pin_2, PORT_Pin_3},
-        .db_ports = {MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTF, MDR_PORTF},
-        .a0_pin = PORT_Pin_0,
-        .a0_port = MDR_PORTC,
-        .e_pin = PORT_Pin_1,
-        .e_port = MDR_PORTC,
-        .e1_pin = PORT_Pin_7,
-        .e1_port = MDR_PORTB,
-        .e2_pin = PORT_Pin_8,
-        .e2_port = MDR_PORTB,
-        .res_pin = PORT_Pin_9,
-        .res_port = MDR_PORTB,
-        .rw_pin = PORT_Pin_10,
-        .rw_port = MDR_PORTB
-    };
+    const TickType_t period = pdMS_TO_TICKS(1000 / LCD_REFRESH_MAX_FPS);
+    TickType_t last = xTaskGetTickCount() - period;
+    TickType_t second = xTaskGetTickCount();
+    TickType_t scheduled = 0;
+    TickType_t delay = portMAX_DELAY;
+    TickType_t wait = portMAX_DELAY;
+
+    lcd_flush_handle = xTaskGetCurrentTaskHandle();
+    lcd0_setup();
+#if LCD_DMA
+    /* lcd_dma_done() runs in the DMA interrupt and uses the FreeRTOS FromISR API. */
+    NVIC_SetPriority(DMA_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY);
+#endif
     DELAY_Init(DELAY_MODE_DWT);
+    /* The GPIO transport always comes up; the EBC one not on a HCLK above 40 MHz. */
+    int8_t ready = lcd_init(&lcd0);
+    configASSERT(ready == 0);
 
-    lcd_init(&lcd0);    
-    uint8_t test[1024];
-    for (int i = 0; i < 1024; i++)
-    {
-        test[i]=0x00;
+    while (1) {
+        ulTaskNotifyTakeIndexed(NOTIFY_WORK, pdTRUE, wait);
+
+        /* Areas and commands arriving meanwhile are drawn in the same pass. */
+        do {
+            uint32_t start = flush_start();
+            if (lcd_lvgl_flush_pending(&lcd0_lvgl) == 0) {
+                /* The area went out together with whatever the commands changed. */
+                flush_done(start);
+                last = xTaskGetTickCount();
+                delay = portMAX_DELAY;
+                xTaskNotifyGiveIndexed(lcd_controller_handle, NOTIFY_DONE);
+            }
+
+            uint8_t drawn = run_commands();
+            if (drawn > 0) {
+                if (delay != portMAX_DELAY) {
+                    lcd_refresh.merged += drawn;
+                } else {
+                    TickType_t now = xTaskGetTickCount();
+                    scheduled = now;
+                    delay = pdMS_TO_TICKS(LCD_REFRESH_MERGE_MS);
+                    if (now - last < period && period - (now - last) > delay)
+                        delay = period - (now - last);
+                    lcd_refresh.merged += drawn - 1;
+                }
+            }
+        } while (lcd0_lvgl.pending || uxQueueMessagesWaiting(lcd_command_queue) > 0);
+
+        TickType_t now = xTaskGetTickCount();
+        if (delay != portMAX_DELAY && now - scheduled >= delay) {
+            uint32_t start = flush_start();
+            flush();
+            flush_done(start);
+            last = xTaskGetTickCount();
+            delay = portMAX_DELAY;
+        }
+
+        now = xTaskGetTickCount();
+        if (now - second >= pdMS_TO_TICKS(1000)) {
+            lcd_refresh.fps = lcd_refresh_frames;
+            lcd_refresh_frames = 0;
+            second = now;
+        }
+
+        if (delay != portMAX_DELAY)
+            wait = delay - (now - scheduled);
+        else if (lcd_refresh_frames > 0 || lcd_refresh.fps > 0)
+            wait = pdMS_TO_TICKS(1000) - (now - second);
+        else
+            wait = portMAX_DELAY;
     }
-    
-    
-    lcd_show_bitmap(&lcd0, test);
+}
 
+void lcd_controller_task(void *pv_arg)
+{
+    lcd_controller_handle = xTaskGetCurrentTaskHandle();
+
+    lv_init();
+    lv_disp_t *disp = lcd_lvgl_init(&lcd0_lvgl, &lcd0);
+    /* LVGL merges its invalidations per refresh period, so that period is its FPS cap. */
+    lv_timer_set_period(_lv_disp_get_refr_timer(disp), 1000 / LCD_REFRESH_MAX_FPS);
+
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "MDR32F9Q2I");
+    lv_obj_center(label);
+
+    /* Sleep until the next LVGL timer is due or someone calls lcd_controller_wake(). Idle
+     * LVGL pauses its refresh and animation timers, so an unchanged screen costs nothing. */
     while (1) {
-        vTaskDelay(500);
+        uint32_t next = lv_timer_handler();
+        ulTaskNotifyTakeIndexed(NOTIFY_WORK, pdTRUE, (next == LV_NO_TIMER_READY) ? portMAX_DELAY : pdMS_TO_TICKS(next));
+    }
+}
+
+/*
+ * Runs first thing in the flush task, which is above the LVGL task and does not block
+ * before lcd_init() is done, so nothing else sees the frame storage uninitialised.
+ */
+static void lcd0_setup(void) {
+    static MDR_PORT_TypeDef *const db_ports[8] = {MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTA, MDR_PORTF, MDR_PORTF};
+    static const uint32_t db_pins[8] = {PORT_Pin_0, PORT_Pin_1, PORT_Pin_2, PORT_Pin_3, PORT_Pin_4, PORT_Pin_5, PORT_Pin_2, PORT_Pin_3};
+
+    memset(&lcd0, 0, sizeof(lcd0));
+    memset(&lcd0_lvgl, 0, sizeof(lcd0_lvgl));
+
+    lcd0.transport = &lcd_transport_gpio;
+    memcpy(lcd0.db_ports, db_ports, sizeof(db_ports));
+    memcpy(lcd0.db_pins, db_pins, sizeof(db_pins));
+    lcd0.a0_pin = PORT_Pin_0;
+    lcd0.a0_port = MDR_PORTC;
+    lcd0.e_pin = PORT_Pin_1;
+    lcd0.e_port = MDR_PORTC;
+    lcd0.e1_pin = PORT_Pin_7;
+    lcd0.e1_port = MDR_PORTB;
+    lcd0.e2_pin = PORT_Pin_8;
+    lcd0.e2_port = MDR_PORTB;
+    lcd0.res_pin = PORT_Pin_9;
+    lcd0.res_port = MDR_PORTB;
+    lcd0.rw_pin = PORT_Pin_10;
+    lcd0.rw_port = MDR_PORTB;
+}
+
+/*
+ * Rejects records that would make the flush task follow a NULL pointer, start off the
+ * panel or invalidate nothing. Anything reaching past the right or bottom edge is
+ * clipped by the drawing functions and lcd_invalidate().
+ */
+static int8_t check_command(const struct lcd_command *command) {
+    switch (command->type) {
+    case LCD_COMMAND_TEXT:
+        return (command->text.font == NULL) ? -1 : 0;
+    case LCD_COMMAND_RECT:
+        return 0;
+    case LCD_COMMAND_BITMAP:
+        return (command->bitmap == NULL || command->x >= LCD_WIDTH || command->y >= LCD_PAGES) ? -1 : 0;
+    case LCD_COMMAND_INVALIDATE:
+        return (command->x >= LCD_WIDTH || command->y >= LCD_HEIGHT ||
+                command->width == 0 || command->height == 0) ? -1 : 0;
+    default:
+        return -1;
+    }
+}
+
+/* Draws up to LCD_COMMAND_BATCH records into the shadow, returns how many. */
+static uint8_t run_commands(void) {
+    struct lcd_command command;
+    uint8_t count = 0;
+
+    while (count < LCD_COMMAND_BATCH && xQueueReceive(lcd_command_queue, &command, 0) == pdTRUE) {
+        run_command(&command);
+        count++;
+    }
+    return count;
+}
+
+static void run_command(struct lcd_command *command) {
+    switch (command->type) {
+    case LCD_COMMAND_TEXT:
+        /* Producers may fill the whole array, so the text ends here at the latest. */
+        command->text.text[LCD_COMMAND_TEXT_MAX - 1] = 0;
+        lcd_draw_text(&lcd0, command->x, command->y, command->text.font, command->text.text);
+        break;
+    case LCD_COMMAND_RECT:
+        lcd_draw_box(&lcd0, command->x, command->y, command->width, command->height, command->mode);
+        break;
+    case LCD_COMMAND_BITMAP:
+        for (uint8_t i = 0; i < command->height && command->y + i < LCD_PAGES; i++)
+            lcd_write_run(&lcd0, command->y + i, command->x, &command->bitmap[i * command->width], command->width);
+        break;
+    case LCD_COMMAND_INVALIDATE:
+        lcd_invalidate(&lcd0, command->x, command->y, command->width, command->height);
+        break;
     }
-}
\ No newline at end of file
+}
+
+static void flush(void) {
+#if LCD_DMA
+    if (lcd_flush_dma(&lcd0) == 0)
+        return;
+#endif
+    lcd_flush(&lcd0);
+}
+
+/* The DWT cycle counter runs since DELAY_Init(DELAY_MODE_DWT). */
+static uint32_t flush_start(void) {
+    return DWT->CYCCNT;
+}
+
+static void flush_done(uint32_t start) {
+    uint32_t us = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+
+    taskENTER_CRITICAL();
+    lcd_refresh.flushes++;
+    lcd_refresh.flush_us = us;
+    if (us > lcd_refresh.flush_us_max)
+        lcd_refresh.flush_us_max = us;
+    taskEXIT_CRITICAL();
+    lcd_refresh_frames++;
+}
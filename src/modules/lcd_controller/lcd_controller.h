@@ -1,6 +1,78 @@
 #ifndef LCD_CONTROLLER_H_
 #define LCD_CONTROLLER_H_
 
+#include "drivers/lcd/lcd_font.h"
+
+/* Records the queue holds; a post fails when it is full. */
+#ifndef LCD_COMMAND_QUEUE_LENGTH
+#define LCD_COMMAND_QUEUE_LENGTH    8
+#endif
+
+/* Records drawn per pass of the flush task before it looks at LVGL again. */
+#ifndef LCD_COMMAND_BATCH
+#define LCD_COMMAND_BATCH           LCD_COMMAND_QUEUE_LENGTH
+#endif
+
+/* Longest text of a record including the terminating zero. */
+#ifndef LCD_COMMAND_TEXT_MAX
+#define LCD_COMMAND_TEXT_MAX        16
+#endif
+
+/* Commands arriving this long after the first one go out in the same flush. */
+#ifndef LCD_REFRESH_MERGE_MS
+#define LCD_REFRESH_MERGE_MS        10
+#endif
+
+/* Upper bound for panel updates per second, LVGL refreshes included. */
+#ifndef LCD_REFRESH_MAX_FPS
+#define LCD_REFRESH_MAX_FPS         30
+#endif
+
+enum lcd_command_types {
+    LCD_COMMAND_TEXT = 0,   /* text at x, y in font */
+    LCD_COMMAND_RECT,       /* filled width x height box drawn with mode */
+    LCD_COMMAND_BITMAP,     /* page-major bitmap, see below */
+    LCD_COMMAND_INVALIDATE  /* resend width x height of the panel as the shadow holds it */
+};
+
+/*
+ * Fixed-size drawing record, copied into the queue. Commands are drawn in RAM coordinates
+ * over whatever LVGL flushed last, and LVGL repaints its own areas on its next refresh.
+ */
+struct lcd_command {
+    uint8_t type;
+    uint8_t x;
+    uint8_t y;              /* LCD_COMMAND_BITMAP: page */
+    uint8_t width;
+    uint8_t height;         /* LCD_COMMAND_BITMAP: pages */
+    uint8_t mode;           /* LCD_COMMAND_RECT: enum lcd_draw_modes */
+    union {
+        struct {
+            const struct lcd_font *font;
+            char text[LCD_COMMAND_TEXT_MAX];
+        } text;
+        /* height page rows of width bytes; only the pointer is queued, so it must stay
+         * valid until the flush task has drawn it, e.g. a const table in flash. */
+        const uint8_t *bitmap;
+    };
+};
+
+/* Counters of the flush task, read them with lcd_controller_stats(). */
+struct lcd_refresh_stats {
+    uint32_t flushes;       /* panel updates, LVGL areas and command batches */
+    uint32_t merged;        /* commands that went out with an earlier one */
+    uint16_t fps;           /* flushes during the last second */
+    uint32_t flush_us;      /* duration of the last flush */
+    uint32_t flush_us_max;
+};
+
+void lcd_controller_init(void);
 void lcd_controller_task(void *pv_arg);
+void lcd_flush_task(void *pv_arg);
+void lcd_controller_wake(void);
+void lcd_controller_wake_from_isr(void);
+int8_t lcd_controller_post(const struct lcd_command *command);
+int8_t lcd_controller_post_from_isr(const struct lcd_command *command);
+void lcd_controller_stats(struct lcd_refresh_stats *stats);
 
-#endif
\ No newline at end of file
+#endif
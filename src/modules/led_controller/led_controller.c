@@ -1,59 +1,56 @@
 #include "led_controller.h"
-#include "drivers/led/led.h"
-#include "drivers/lcd/lcd.h"
 
-#include <FreeRTOS.h>
-#include <task.h>
+#include <MDR32FxQI_rst_clk.h>
+#include <MDR32FxQI_timer.h>
 
-void led0_controller_task(void *pv_arg)
-{
-    struct led led0 = {
-        .port = MDR_PORTB,
-        .pin = PORT_Pin_0,
-    };
-    
-    while (1) {
-        led_toggle(&led0);
-        vTaskDelay(200);
-    }
-}
+/* TIMER1 counts at 100 kHz and wraps every LED_CONTROLLER_TICK_MS. */
+#define LED_TIMER_CLOCK_HZ  100000
+
+#define MS(ms)  ((ms) / LED_CONTROLLER_TICK_MS)
+
+/* The PORTB LEDs blinking at 50% duty, each at half the rate of the previous one. */
+static struct led_channel channels[LED_CONTROLLER_LEDS] = {
+    [LED_CONTROLLER_LED0] = {.pin = PORT_Pin_0, .pattern = {.period = MS(400), .on = MS(200)}},
+    [LED_CONTROLLER_LED1] = {.pin = PORT_Pin_1, .pattern = {.period = MS(800), .on = MS(400)}},
+    [LED_CONTROLLER_LED2] = {.pin = PORT_Pin_2, .pattern = {.period = MS(1600), .on = MS(800)}},
+    [LED_CONTROLLER_LED3] = {.pin = PORT_Pin_3, .pattern = {.period = MS(3200), .on = MS(1600)}},
+};
+
+static struct led_engine leds = {
+    .port = MDR_PORTB,
+    .channels = channels,
+    .count = LED_CONTROLLER_LEDS,
+};
 
-void led1_controller_task(void *pv_arg)
+/* Replaces the four blink tasks: one timer interrupt updates all LEDs, no task or stack. */
+void led_controller_init(void)
 {
-    struct led led1 = {
-        .port = MDR_PORTB,
-        .pin = PORT_Pin_1,
-    };
-
-    while (1) {
-        led_toggle(&led1);
-        vTaskDelay(400);
-    }
+    TIMER_CntInitTypeDef cnt;
+
+    led_engine_init(&leds);
+
+    RST_CLK_PCLKcmd(RST_CLK_PCLK_TIMER1, ENABLE);
+    TIMER_BRGInit(MDR_TIMER1, TIMER_HCLKdiv1);
+
+    TIMER_CntStructInit(&cnt);
+    cnt.TIMER_Prescaler = SystemCoreClock / LED_TIMER_CLOCK_HZ - 1;
+    cnt.TIMER_Period = LED_TIMER_CLOCK_HZ / 1000 * LED_CONTROLLER_TICK_MS - 1;
+    TIMER_CntInit(MDR_TIMER1, &cnt);
+
+    TIMER_ITConfig(MDR_TIMER1, TIMER_STATUS_CNT_ARR, ENABLE);
+    NVIC_SetPriority(Timer1_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+    NVIC_EnableIRQ(Timer1_IRQn);
+    TIMER_Cmd(MDR_TIMER1, ENABLE);
 }
 
-void led2_controller_task(void *pv_arg)
+void led_controller_set(uint8_t led, const struct led_pattern *pattern)
 {
-    struct led led2 = {
-        .port = MDR_PORTB,
-        .pin = PORT_Pin_2,
-    };
-
-    while (1) {
-        led_toggle(&led2);
-        vTaskDelay(800);
-    }
+    led_engine_set(&leds, led, pattern);
 }
 
-void led3_controller_task(void *pv_arg)
+/* To be called from Timer1_IRQHandler. */
+void led_controller_irq_handler(void)
 {
-    struct led led3 = {
-        .port = MDR_PORTB,
-        .pin = PORT_Pin_3,
-    };
-
-    while (1) {
-        led_toggle(&led3);
-        vTaskDelay(1600);
-    }
+    TIMER_ClearFlag(MDR_TIMER1, TIMER_STATUS_CNT_ARR);
+    led_engine_tick(&leds);
 }
-
@@ -1,9 +1,21 @@
 #ifndef LED_CONTROLLER_H_
 #define LED_CONTROLLER_H_
 
-void led0_controller_task(void *pv_arg);
-void led1_controller_task(void *pv_arg);
-void led2_controller_task(void *pv_arg);
-void led3_controller_task(void *pv_arg);
+#include "drivers/led/led.h"
+
+/* Engine tick, the unit of struct led_pattern. */
+#define LED_CONTROLLER_TICK_MS  10
+
+enum led_controller_leds {
+    LED_CONTROLLER_LED0 = 0,
+    LED_CONTROLLER_LED1,
+    LED_CONTROLLER_LED2,
+    LED_CONTROLLER_LED3,
+    LED_CONTROLLER_LEDS
+};
+
+void led_controller_init(void);
+void led_controller_set(uint8_t led, const struct led_pattern *pattern);
+void led_controller_irq_handler(void);
 
 #endif
@@ -3,21 +3,47 @@
 #include "modules/lcd_controller/lcd_controller.h"
 #include <FreeRTOSConfig.h>
 
-void threads_init(void)
-{
-    xTaskCreate(led0_controller_task, "led0_controller", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+enum threads {
+    THREAD_LCD_CONTROLLER = 0,
+    THREAD_LCD_FLUSH,
+    THREADS
+};
 
-    xTaskCreate(led1_controller_task, "led1_controller", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+static TaskHandle_t threads[THREADS];
 
-    xTaskCreate(led2_controller_task, "led2_controller", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+/* Returns -1 when the heap cannot hold a task, the scheduler must not start then. */
+int8_t threads_init(void)
+{
+    led_controller_init();
+    lcd_controller_init();
 
-    xTaskCreate(led3_controller_task, "led3_controller", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+    if (xTaskCreate(lcd_controller_task, "lcd_controller", LCD_CONTROLLER_STACK, NULL, tskIDLE_PRIORITY, &threads[THREAD_LCD_CONTROLLER]) != pdPASS)
+        return -1;
 
-    xTaskCreate(lcd_controller_task, "lcd_controller", configMINIMAL_STACK_SIZE * 3, NULL, tskIDLE_PRIORITY, NULL);
+    if (xTaskCreate(lcd_flush_task, "lcd_flush", LCD_FLUSH_STACK, NULL, tskIDLE_PRIORITY + 1, &threads[THREAD_LCD_FLUSH]) != pdPASS)
+        return -1;
 
+    return 0;
 }
 
 void kernel_start(void)
 {
     vTaskStartScheduler();
 }
+
+/* Fills free with the fewest unused stack words each task has had so far, in creation order. */
+void threads_stack_free(UBaseType_t free[], uint8_t count)
+{
+    for (uint8_t i = 0; i < count && i < THREADS; i++) {
+        free[i] = (threads[i] != NULL) ? uxTaskGetStackHighWaterMark(threads[i]) : 0;
+    }
+}
+
+/* Called on a context switch out of a task that overran its stack; halts for the debugger. */
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
+{
+    taskDISABLE_INTERRUPTS();
+    while (1) {
+        ;
+    }
+}
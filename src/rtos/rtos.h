@@ -4,7 +4,27 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
-void threads_init(void);
+/*
+ * Task stack depths in words, taken from the heap. Size them from threads_stack_free()
+ * after going through every screen and keep about a quarter of each stack unused;
+ * configCHECK_FOR_STACK_OVERFLOW catches a task that runs past its end.
+ *
+ * Not measured on the target yet, both values are provisional and the sizing from
+ * high-water marks is still to be done. Together they take 4 KB of heap, 0.5 KB more
+ * than the four LED tasks and the LCD task did before, so nothing is freed so far.
+ *
+ * Flush task: an estimate only. Its driver calls take at most 384 bytes in the x86-64
+ * call graph (target stack_usage of tests/host, SPL calls not counted); with its own
+ * frames, the kernel calls and the 32 byte exception frame about 0.6 KB. LVGL task: a
+ * guess, LVGL asks for more than 2 KB to render and 1 KB is kept on top of that.
+ *
+ * Measured free words (threads_stack_free()): controller -, flush -.
+ */
+#define LCD_CONTROLLER_STACK    (configMINIMAL_STACK_SIZE * 6)  /* 3 KB */
+#define LCD_FLUSH_STACK         (configMINIMAL_STACK_SIZE * 2)  /* 1 KB */
+
+int8_t threads_init(void);
 void kernel_start(void);
+void threads_stack_free(UBaseType_t free[], uint8_t count);
 
 #endif
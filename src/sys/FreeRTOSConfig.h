@@ -45,13 +45,14 @@
 #define configSUPPORT_DYNAMIC_ALLOCATION    1
 #define conifgSUPPORT_STATIC_ALLOCATION     0
 #define configUSE_IDLE_HOOK			        0
-#define configUSE_TICK_HOOK			        0
+#define configUSE_TICK_HOOK			        1
 #define configCPU_CLOCK_HZ			        ( ( unsigned long ) 80000000 )
 #define configTICK_RATE_HZ			        ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES		        ( 5 )
 #define configMINIMAL_STACK_SIZE	        ( ( unsigned short ) 128 )
 #define configTOTAL_HEAP_SIZE		        ( ( size_t ) 8192 )
 #define configMAX_TASK_NAME_LEN		        ( 16 )
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES  ( 2 )
 #define configUSE_TRACE_FACILITY	        1
 #define configUSE_16_BIT_TICKS		        0
 #define configIDLE_SHOULD_YIELD		        1
@@ -64,7 +65,7 @@
 #define configUSE_MUTEXES				1
 #define configUSE_COUNTING_SEMAPHORES 	1
 #define configUSE_ALTERNATIVE_API 		0
-#define configCHECK_FOR_STACK_OVERFLOW	0
+#define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configQUEUE_REGISTRY_SIZE		0
 #define configGENERATE_RUN_TIME_STATS	0
@@ -79,6 +80,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -1,4 +1,6 @@
 #include "irq.h"
+#include "drivers/lcd/lcd.h"
+#include "modules/led_controller/led_controller.h"
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -148,6 +150,9 @@ void USB_IRQHandler(void)
 *******************************************************************************/
 void DMA_IRQHandler(void)
 {
+#if LCD_DMA
+  lcd_dma_irq_handler();
+#endif
 }
 /*******************************************************************************
 * Function Name  : UART1_IRQHandler
@@ -219,6 +224,7 @@ void WWDG_IRQHandler(void)
 *******************************************************************************/
 void Timer1_IRQHandler(void)
 {
+  led_controller_irq_handler();
 }
 /*******************************************************************************
 * Function Name  : Timer2_IRQHandler
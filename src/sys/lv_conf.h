@@ -0,0 +1,141 @@
+/*
+ * LVGL v8 configuration for the MT-12864 panel: 1bpp, a few widgets and one
+ * monospace font to fit 128 KB of flash and 32 KB of RAM.
+ * Everything not set here takes its default from lv_conf_internal.h.
+ */
+
+#if 1
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+/* Color */
+#define LV_COLOR_DEPTH                  1
+#define LV_COLOR_SCREEN_TRANSP          0
+
+/* Memory: LVGL heap outside the FreeRTOS one */
+#define LV_MEM_CUSTOM                   0
+#define LV_MEM_SIZE                     (10U * 1024U)
+#define LV_MEM_ADR                      0
+#define LV_MEM_BUF_MAX_NUM              8
+#define LV_MEMCPY_MEMSET_STD            1
+
+/* HAL */
+#define LV_DISP_DEF_REFR_PERIOD         30
+#define LV_INDEV_DEF_READ_PERIOD        30
+#define LV_TICK_CUSTOM                  0
+#define LV_DPI_DEF                      100
+
+/* Drawing */
+#define LV_DRAW_COMPLEX                 0
+#define LV_LAYER_SIMPLE_BUF_SIZE        (1 * 1024)
+#define LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE (1 * 1024)
+#define LV_IMG_CACHE_DEF_SIZE           0
+#define LV_GRADIENT_MAX_STOPS           2
+#define LV_GRAD_CACHE_DEF_SIZE          0
+#define LV_DISP_ROT_MAX_BUF             (1 * 1024)
+
+/* Logging, asserts and monitors */
+#define LV_USE_LOG                      0
+#define LV_USE_ASSERT_NULL              1
+#define LV_USE_ASSERT_MALLOC            1
+#define LV_USE_ASSERT_STYLE             0
+#define LV_USE_ASSERT_MEM_INTEGRITY     0
+#define LV_USE_ASSERT_OBJ               0
+#define LV_USE_PERF_MONITOR             0
+#define LV_USE_MEM_MONITOR              0
+#define LV_USE_REFR_DEBUG               0
+
+/* Others */
+#define LV_SPRINTF_CUSTOM               0
+#define LV_SPRINTF_USE_FLOAT            0
+#define LV_USE_USER_DATA                1
+#define LV_ENABLE_GC                    0
+
+/* Fonts */
+#define LV_FONT_MONTSERRAT_14           0
+#define LV_FONT_UNSCII_8                1
+#define LV_FONT_DEFAULT                 &lv_font_unscii_8
+#define LV_USE_FONT_COMPRESSED          0
+#define LV_USE_FONT_SUBPX               0
+
+/* Text */
+#define LV_TXT_ENC                      LV_TXT_ENC_UTF8
+#define LV_USE_BIDI                     0
+#define LV_USE_ARABIC_PERSIAN_CHARS     0
+
+/* Widgets */
+#define LV_USE_ARC                      0
+#define LV_USE_BAR                      1
+#define LV_USE_BTN                      1
+#define LV_USE_BTNMATRIX                0
+#define LV_USE_CANVAS                   0
+#define LV_USE_CHECKBOX                 0
+#define LV_USE_DROPDOWN                 0
+#define LV_USE_IMG                      1
+#define LV_USE_LABEL                    1
+#define LV_LABEL_TEXT_SELECTION         0
+#define LV_LABEL_LONG_TXT_HINT          0
+#define LV_USE_LINE                     1
+#define LV_USE_ROLLER                   0
+#define LV_USE_SLIDER                   0
+#define LV_USE_SWITCH                   0
+#define LV_USE_TEXTAREA                 0
+#define LV_USE_TABLE                    0
+
+/* Extra widgets */
+#define LV_USE_ANIMIMG                  0
+#define LV_USE_CALENDAR                 0
+#define LV_USE_CHART                    0
+#define LV_USE_COLORWHEEL               0
+#define LV_USE_IMGBTN                   0
+#define LV_USE_KEYBOARD                 0
+#define LV_USE_LED                      0
+#define LV_USE_LIST                     0
+#define LV_USE_MENU                     0
+#define LV_USE_METER                    0
+#define LV_USE_MSGBOX                   0
+#define LV_USE_SPAN                     0
+#define LV_USE_SPINBOX                  0
+#define LV_USE_SPINNER                  0
+#define LV_USE_TABVIEW                  0
+#define LV_USE_TILEVIEW                 0
+#define LV_USE_WIN                      0
+
+/* Themes */
+#define LV_USE_THEME_DEFAULT            0
+#define LV_USE_THEME_BASIC              0
+#define LV_USE_THEME_MONO               1
+
+/* Layouts */
+#define LV_USE_FLEX                     1
+#define LV_USE_GRID                     0
+
+/* 3rd party libraries and extra modules */
+#define LV_USE_FS_STDIO                 0
+#define LV_USE_FS_POSIX                 0
+#define LV_USE_FS_FATFS                 0
+#define LV_USE_PNG                      0
+#define LV_USE_BMP                      0
+#define LV_USE_SJPG                     0
+#define LV_USE_GIF                      0
+#define LV_USE_QRCODE                   0
+#define LV_USE_FREETYPE                 0
+#define LV_USE_TINY_TTF                 0
+#define LV_USE_RLOTTIE                  0
+#define LV_USE_FFMPEG                   0
+#define LV_USE_SNAPSHOT                 0
+#define LV_USE_MONKEY                   0
+#define LV_USE_GRIDNAV                  0
+#define LV_USE_FRAGMENT                 0
+#define LV_USE_IMGFONT                  0
+#define LV_USE_MSG                      0
+#define LV_USE_IME_PINYIN               0
+
+#define LV_BUILD_EXAMPLES               0
+
+#endif /*LV_CONF_H*/
+
+#endif /*End of "Content enable"*/
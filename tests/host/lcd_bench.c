@@ -0,0 +1,59 @@
+#include "lcd_host.h"
+#include "drivers/lcd/lcd_draw.h"
+#include "drivers/lcd/lcd_font.h"
+#include "font_5x7.h"
+
+/*
+ * Bus cost of the common screen updates through the GPIO transport, each one drawn into
+ * the shadow and flushed. The counts are exact, so a change to the driver shows up here
+ * as a change in register accesses and E strobes per operation. Fails if any E edge came
+ * without the delay the controller needs after it.
+ */
+static struct lcd lcd;
+static struct lcd_bus_sim sim;
+static uint32_t short_edges;
+
+static void bench_fill(void) {
+    lcd_fill(&lcd, 1);
+    lcd_flush(&lcd);
+    lcd_bus_sim_report(&sim, "fill", stdout);
+}
+
+static void bench_bitmap(void) {
+    static uint8_t bitmap[LCD_HEIGHT * LCD_WIDTH / 8];
+
+    for (uint16_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 37 + (i >> 4));
+    }
+    lcd_show_bitmap(&lcd, bitmap);
+    lcd_flush(&lcd);
+    lcd_bus_sim_report(&sim, "full bitmap", stdout);
+}
+
+static void bench_partial(void) {
+    lcd_draw_box(&lcd, 50, 20, 20, 10, LCD_DRAW_XOR);
+    lcd_flush(&lcd);
+    lcd_bus_sim_report(&sim, "partial 20x10 box", stdout);
+}
+
+static void bench_text(void) {
+    lcd_draw_text(&lcd, 3, 17, &lcd_font_5x7, "Hello");
+    lcd_flush(&lcd);
+    lcd_bus_sim_report(&sim, "text \"Hello\"", stdout);
+}
+
+int main(void) {
+    static void (*const benches[])(void) = {bench_fill, bench_bitmap, bench_partial, bench_text};
+
+    for (uint8_t wait = LCD_WAIT_DELAY; wait <= LCD_WAIT_BUSY; wait++) {
+        printf("%s\n", (wait == LCD_WAIT_DELAY) ? "delay timing" : "busy polling");
+        for (uint8_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+            lcd_host_init(&lcd, &sim, wait, NULL);
+            benches[i]();
+            short_edges += sim.short_edges;
+        }
+    }
+    if (short_edges != 0)
+        printf("%lu E edges without a delay\n", (unsigned long)short_edges);
+    return short_edges != 0;
+}
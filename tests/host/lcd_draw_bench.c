@@ -0,0 +1,151 @@
+#include "lcd_host.h"
+#include "drivers/lcd/lcd_draw.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Each primitive against the same shape drawn with lcd_draw_pixel() calls. With the
+ * shadow both reach the same dirty bytes, so the flush costs the same and the difference
+ * is host time; without it every call is a read-modify-write and the difference shows
+ * in the bus counts.
+ */
+#define REPEAT  20000
+
+struct shape {
+    const char *name;
+    void (*primitive)(uint8_t mode);
+    void (*pixels)(uint8_t mode);
+};
+
+static struct lcd lcd;
+static struct lcd_bus_sim sim;
+
+static void box(uint8_t mode) {
+    lcd_draw_box(&lcd, 10, 10, 100, 40, mode);
+}
+
+static void box_pixels(uint8_t mode) {
+    for (uint8_t y = 10; y < 50; y++) {
+        for (uint8_t x = 10; x < 110; x++) {
+            lcd_draw_pixel(&lcd, x, y, mode);
+        }
+    }
+}
+
+static void hline(uint8_t mode) {
+    lcd_draw_hline(&lcd, 10, 21, 100, mode);
+}
+
+static void hline_pixels(uint8_t mode) {
+    for (uint8_t x = 10; x < 110; x++) {
+        lcd_draw_pixel(&lcd, x, 21, mode);
+    }
+}
+
+static void vline(uint8_t mode) {
+    lcd_draw_vline(&lcd, 40, 5, 50, mode);
+}
+
+static void vline_pixels(uint8_t mode) {
+    for (uint8_t y = 5; y < 55; y++) {
+        lcd_draw_pixel(&lcd, 40, y, mode);
+    }
+}
+
+/* Same pixels as lcd_draw_line(), see the model in lcd_draw_test.c. */
+static void pixel_line(int x0, int y0, int x1, int y1, uint8_t mode) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int err = ((dx >= dy) ? dx : dy) / 2;
+
+    if (dx >= dy) {
+        for (int x = x0, y = y0; x <= x1; x++) {
+            lcd_draw_pixel(&lcd, x, y, mode);
+            err -= dy;
+            if (err < 0) {
+                y += (y0 < y1) ? 1 : -1;
+                err += dx;
+            }
+        }
+    } else {
+        for (int y = y0, x = x0; y <= y1; y++) {
+            lcd_draw_pixel(&lcd, x, y, mode);
+            err -= dx;
+            if (err < 0) {
+                x += (x0 < x1) ? 1 : -1;
+                err += dy;
+            }
+        }
+    }
+}
+
+static void shallow_line(uint8_t mode) {
+    lcd_draw_line(&lcd, 0, 0, 127, 63, mode);
+}
+
+static void shallow_line_pixels(uint8_t mode) {
+    pixel_line(0, 0, 127, 63, mode);
+}
+
+static void steep_line(uint8_t mode) {
+    lcd_draw_line(&lcd, 10, 0, 40, 63, mode);
+}
+
+static void steep_line_pixels(uint8_t mode) {
+    pixel_line(10, 0, 40, 63, mode);
+}
+
+static const struct shape shapes[] = {
+    {"box 100x40", box, box_pixels},
+    {"hline 100", hline, hline_pixels},
+    {"vline 50", vline, vline_pixels},
+    {"line 127x63", shallow_line, shallow_line_pixels},
+    {"line 30x63", steep_line, steep_line_pixels},
+};
+
+#if LCD_SHADOW
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* XOR changes every covered byte on every call, so no call is skipped as unchanged. */
+static double time_ns(void (*draw)(uint8_t mode)) {
+    double start = now_ns();
+
+    for (uint32_t i = 0; i < REPEAT; i++) {
+        draw(LCD_DRAW_XOR);
+    }
+    return (now_ns() - start) / REPEAT;
+}
+#endif
+
+static void run(const char *label, void (*draw)(uint8_t mode)) {
+    lcd_host_init(&lcd, &sim, LCD_WAIT_DELAY, NULL);
+    draw(LCD_DRAW_SET);
+#if LCD_SHADOW
+    lcd_flush(&lcd);
+#endif
+    lcd_bus_sim_report(&sim, label, stdout);
+}
+
+int main(void) {
+    printf("%s\n", LCD_SHADOW ? "shadow, drawing and lcd_flush()" : "no shadow, read-modify-write on the panel");
+    for (uint8_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        char label[32];
+
+        snprintf(label, sizeof(label), "%s", shapes[i].name);
+        run(label, shapes[i].primitive);
+        snprintf(label, sizeof(label), "%s pixels", shapes[i].name);
+        run(label, shapes[i].pixels);
+#if LCD_SHADOW
+        double primitive = time_ns(shapes[i].primitive);
+        double pixels = time_ns(shapes[i].pixels);
+        printf("%-24s host %8.0f ns, pixels %8.0f ns (%.1fx)\n", shapes[i].name, primitive, pixels, pixels / primitive);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "lcd_host.h"
+#include "drivers/lcd/lcd_draw.h"
+
+#include <stdlib.h>
+
+/*
+ * The drawing primitives against a per-pixel model: random pixels, lines, outlines and
+ * boxes in all three modes, partly off screen, drawn on the simulated panel and on a
+ * plain pixel array. Built with and without the shadow; without it every primitive is a
+ * read-modify-write on the panel.
+ */
+#define OPERATIONS  5000
+
+static struct lcd lcd;
+static struct lcd_bus_sim sim;
+static uint8_t model[LCD_HEIGHT][LCD_WIDTH];
+
+static void model_pixel(int x, int y, uint8_t mode) {
+    if (x < 0 || y < 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT)
+        return;
+    model[y][x] = (mode == LCD_DRAW_XOR) ? !model[y][x] : mode;
+}
+
+static void model_box(int x, int y, int width, int height, uint8_t mode) {
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            model_pixel(x + i, y + j, mode);
+        }
+    }
+}
+
+/* Textbook Bresenham with the same tie rules as lcd_draw_line(), one pixel at a time. */
+static void model_line(int x0, int y0, int x1, int y1, uint8_t mode) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int t;
+
+    if (dx >= dy) {
+        if (x0 > x1) {
+            t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+        }
+        int step = (y0 < y1) ? 1 : -1;
+        int err = dx / 2;
+        for (int x = x0, y = y0; x <= x1; x++) {
+            model_pixel(x, y, mode);
+            err -= dy;
+            if (err < 0) {
+                y += step;
+                err += dx;
+            }
+        }
+    } else {
+        if (y0 > y1) {
+            t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+        }
+        int step = (x0 < x1) ? 1 : -1;
+        int err = dy / 2;
+        for (int y = y0, x = x0; y <= y1; y++) {
+            model_pixel(x, y, mode);
+            err -= dx;
+            if (err < 0) {
+                x += step;
+                err += dy;
+            }
+        }
+    }
+}
+
+static void model_rect(int x, int y, int width, int height, uint8_t mode) {
+    if (width == 0 || height == 0)
+        return;
+    model_box(x, y, width, 1, mode);
+    if (height > 1)
+        model_box(x, y + height - 1, width, 1, mode);
+    if (height > 2) {
+        model_box(x, y + 1, 1, height - 2, mode);
+        if (width > 1)
+            model_box(x + width - 1, y + 1, 1, height - 2, mode);
+    }
+}
+
+/* Far edges past 255 that would wrap into the screen as uint8_t; pixels off the model. */
+static uint32_t wrapping_rects(void) {
+    static const uint8_t rects[][4] = {
+        {200, 10, 100, 20}, {10, 250, 20, 20}, {100, 50, 200, 250}, {255, 255, 255, 255},
+        {120, 255, 30, 40}, {250, 60, 30, 3}, {60, 20, 250, 10}
+    };
+
+    for (uint8_t i = 0; i < sizeof(rects) / sizeof(rects[0]); i++) {
+        const uint8_t *r = rects[i];
+        lcd_draw_rect(&lcd, r[0], r[1], r[2], r[3], LCD_DRAW_XOR);
+        model_rect(r[0], r[1], r[2], r[3], LCD_DRAW_XOR);
+    }
+#if LCD_SHADOW
+    lcd_flush(&lcd);
+#endif
+    return lcd_host_compare(&sim, model);
+}
+
+int main(void) {
+    uint32_t wrapped;
+    uint32_t wrong;
+
+    lcd_host_init(&lcd, &sim, LCD_WAIT_DELAY, NULL);
+    wrapped = wrapping_rects();
+    srand(3);
+    for (uint32_t i = 0; i < OPERATIONS; i++) {
+        uint8_t mode = rand() % 3;
+        uint8_t x = rand() % 140;
+        uint8_t y = rand() % 72;
+        uint8_t width = rand() % 70;
+        uint8_t height = rand() % 40;
+
+        switch (rand() % 6) {
+        case 0:
+            lcd_draw_pixel(&lcd, x, y, mode);
+            model_pixel(x, y, mode);
+            break;
+        case 1:
+            lcd_draw_hline(&lcd, x, y, width, mode);
+            model_box(x, y, width, 1, mode);
+            break;
+        case 2:
+            lcd_draw_vline(&lcd, x, y, height, mode);
+            model_box(x, y, 1, height, mode);
+            break;
+        case 3:
+            lcd_draw_box(&lcd, x, y, width, height, mode);
+            model_box(x, y, width, height, mode);
+            break;
+        case 4:
+            lcd_draw_rect(&lcd, x, y, width, height, mode);
+            model_rect(x, y, width, height, mode);
+            break;
+        case 5:
+            x %= LCD_WIDTH;
+            y %= LCD_HEIGHT;
+            width = rand() % LCD_WIDTH;
+            height = rand() % LCD_HEIGHT;
+            lcd_draw_line(&lcd, x, y, width, height, mode);
+            model_line(x, y, width, height, mode);
+            break;
+        }
+#if LCD_SHADOW
+        if (i % 7 == 0)
+            lcd_flush(&lcd);
+#endif
+    }
+#if LCD_SHADOW
+    lcd_flush(&lcd);
+#endif
+    wrong = lcd_host_compare(&sim, model);
+
+    printf("%s: %lu pixels differ from the model after the wrapping outlines, %lu at the end\n",
+           LCD_SHADOW ? "shadow" : "direct", (unsigned long)wrapped, (unsigned long)wrong);
+    return wrapped != 0 || wrong != 0;
+}
@@ -0,0 +1,61 @@
+#include "lcd_host.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* lcd_bus_sim_ports[0..5] stand for PORTA..PORTF. */
+#define PORT_A  (&lcd_bus_sim_ports[0])
+#define PORT_B  (&lcd_bus_sim_ports[1])
+#define PORT_C  (&lcd_bus_sim_ports[2])
+#define PORT_F  (&lcd_bus_sim_ports[5])
+
+void lcd_host_init(struct lcd *lcd, struct lcd_bus_sim *sim, uint8_t wait_mode, FILE *trace) {
+    static MDR_PORT_TypeDef *const db_ports[8] = {PORT_A, PORT_A, PORT_A, PORT_A, PORT_A, PORT_A, PORT_F, PORT_F};
+    static const uint32_t db_pins[8] = {PORT_Pin_0, PORT_Pin_1, PORT_Pin_2, PORT_Pin_3, PORT_Pin_4, PORT_Pin_5, PORT_Pin_2, PORT_Pin_3};
+
+    memset(lcd, 0, sizeof(*lcd));
+    lcd->transport = &lcd_transport_gpio;
+    lcd->wait_mode = wait_mode;
+    memcpy(lcd->db_ports, db_ports, sizeof(db_ports));
+    memcpy(lcd->db_pins, db_pins, sizeof(db_pins));
+    lcd->a0_pin = PORT_Pin_0;
+    lcd->a0_port = PORT_C;
+    lcd->e_pin = PORT_Pin_1;
+    lcd->e_port = PORT_C;
+    lcd->e1_pin = PORT_Pin_7;
+    lcd->e1_port = PORT_B;
+    lcd->e2_pin = PORT_Pin_8;
+    lcd->e2_port = PORT_B;
+    lcd->res_pin = PORT_Pin_9;
+    lcd->res_port = PORT_B;
+    lcd->rw_pin = PORT_Pin_10;
+    lcd->rw_port = PORT_B;
+
+    lcd_bus_sim_attach(sim, lcd, trace);
+    sim->busy_polls = (wait_mode == LCD_WAIT_BUSY) ? 2 : 0;
+    if (lcd_init(lcd) < 0)
+        abort();
+    lcd_bus_sim_reset_counters(sim);
+}
+
+uint32_t lcd_host_compare(const struct lcd_bus_sim *sim, const uint8_t expected[LCD_HEIGHT][LCD_WIDTH]) {
+    uint32_t wrong = 0;
+
+    for (uint8_t y = 0; y < LCD_HEIGHT; y++) {
+        for (uint8_t x = 0; x < LCD_WIDTH; x++) {
+            if (lcd_sim_pixel(&sim->panel, x, y) != expected[y][x])
+                wrong++;
+        }
+    }
+    return wrong;
+}
+
+void lcd_host_transpose8_bits(const uint8_t *rows, uint32_t stride, uint8_t *columns) {
+    for (uint8_t k = 0; k < 8; k++) {
+        uint8_t data = 0x00;
+        for (uint8_t row = 0; row < 8; row++) {
+            data |= ((rows[row * stride] >> (7 - k)) & 0x01) << row;
+        }
+        columns[k] = data;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef LCD_HOST_H_
+#define LCD_HOST_H_
+
+#include "drivers/lcd/lcd_bus_sim.h"
+
+/*
+ * Wires a struct lcd to the bus simulator with the pin mapping of the firmware
+ * (lcd0_setup() in the LCD controller) and runs lcd_init(). With LCD_WAIT_BUSY the
+ * simulated chips report BUSY twice after every write. The counters are reset
+ * afterwards, so they start at the first operation of the caller.
+ */
+void lcd_host_init(struct lcd *lcd, struct lcd_bus_sim *sim, uint8_t wait_mode, FILE *trace);
+
+/* Pixels where the virtual panel differs from expected[y][x], 0 or 1 each. */
+uint32_t lcd_host_compare(const struct lcd_bus_sim *sim, const uint8_t expected[LCD_HEIGHT][LCD_WIDTH]);
+
+/* The per-bit conversion lcd_show_bitmap() used before lcd_transpose8(), one 8x8 block. */
+void lcd_host_transpose8_bits(const uint8_t *rows, uint32_t stride, uint8_t *columns);
+
+#endif
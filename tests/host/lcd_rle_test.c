@@ -0,0 +1,138 @@
+#include "lcd_host.h"
+#include "drivers/lcd/lcd_rle.h"
+#include "rle_test.h"
+
+#include <string.h>
+
+/*
+ * lcd_show_rle() against the PBM that tools/rlegen.py compressed into lcd_image_rle_test
+ * at build time: the panel RAM must match the image byte for byte. Truncated and corrupt
+ * streams must return -1, draw the records that were complete and nothing else.
+ */
+static struct lcd lcd;
+static struct lcd_bus_sim sim;
+static uint8_t image[LCD_PAGES][LCD_WIDTH];
+static uint32_t failed;
+
+/* Page-major frame of the P1 test image; no comments after the size line. */
+static int8_t read_image(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[256];
+    uint8_t header = 0;
+    uint16_t pixel = 0;
+    int c;
+
+    if (f == NULL)
+        return -1;
+    while (header < 2 && fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] != '#')
+            header++;
+    }
+    while ((c = fgetc(f)) != EOF && pixel < LCD_WIDTH * LCD_HEIGHT) {
+        if (c != '0' && c != '1')
+            continue;
+        uint8_t x = pixel % LCD_WIDTH;
+        uint8_t y = pixel / LCD_WIDTH;
+        if (c == '1')
+            image[y / 8][x] |= 1 << (y % 8);
+        pixel++;
+    }
+    fclose(f);
+    return (pixel == LCD_WIDTH * LCD_HEIGHT) ? 0 : -1;
+}
+
+/* The records of stream that are complete and fit the screen, drawn over frame. */
+static void decode_complete(const uint8_t *stream, uint16_t size, uint8_t frame[LCD_PAGES][LCD_WIDTH]) {
+    uint8_t *out = &frame[0][0];
+    uint16_t offset = 0;
+    uint16_t i = 0;
+
+    while (i < size) {
+        uint8_t control = stream[i];
+        uint16_t length = (control & 0x80) ? (control & 0x7F) + LCD_RLE_RUN_MIN : control + 1;
+        uint16_t record = (control & 0x80) ? 2 : length + 1;
+
+        if (offset + length > LCD_PAGES * LCD_WIDTH || size - i < record)
+            return;
+        for (uint16_t j = 0; j < length; j++) {
+            out[offset + j] = (control & 0x80) ? stream[i + 1] : stream[i + 1 + j];
+        }
+        offset += length;
+        i += record;
+    }
+}
+
+static uint32_t panel_diff(const uint8_t expected[LCD_PAGES][LCD_WIDTH]) {
+    uint32_t wrong = 0;
+
+    for (uint8_t page = 0; page < LCD_PAGES; page++) {
+        for (uint8_t x = 0; x < LCD_WIDTH; x++) {
+            if (sim.panel.ram[x / LCD_PART_WIDTH][page][x % LCD_PART_WIDTH] != expected[page][x])
+                wrong++;
+        }
+    }
+    return wrong;
+}
+
+/* Shows stream on a panel filled with 1s first and checks result and panel RAM. */
+static void check(const char *test, const uint8_t *stream, uint16_t size, int8_t result) {
+    static uint8_t expected[LCD_PAGES][LCD_WIDTH];
+    const struct lcd_rle_image rle = {.size = size, .data = stream};
+    uint32_t wrong;
+    int8_t got;
+
+    lcd_host_init(&lcd, &sim, LCD_WAIT_DELAY, NULL);
+    lcd_fill(&lcd, 1);
+    lcd_flush(&lcd);
+    memset(expected, 0xFF, sizeof(expected));
+    decode_complete(stream, size, expected);
+
+    got = lcd_show_rle(&lcd, &rle);
+    wrong = panel_diff(expected);
+    if (got != result || wrong != 0) {
+        printf("%s: returned %d, %lu bytes differ\n", test, got, (unsigned long)wrong);
+        failed++;
+    }
+}
+
+int main(void) {
+    static uint8_t stream[2048];
+    const uint16_t size = lcd_image_rle_test.size;
+
+    if (read_image(RLE_TEST_IMAGE) < 0) {
+        printf("cannot read %s\n", RLE_TEST_IMAGE);
+        return 1;
+    }
+
+    check("image", lcd_image_rle_test.data, size, 0);
+    if (panel_diff(image) != 0) {
+        printf("image: panel differs from %s\n", RLE_TEST_IMAGE);
+        failed++;
+    }
+
+    /* Cut inside a literal, inside a run record, right after a record, and empty. */
+    for (uint16_t cut = 1; cut < size; cut += 37) {
+        check("truncated", lcd_image_rle_test.data, cut, -1);
+    }
+    check("truncated to nothing", lcd_image_rle_test.data, 0, -1);
+
+    /* A trailing run past the last page is dropped, the screen itself is complete. */
+    memcpy(stream, lcd_image_rle_test.data, size);
+    stream[size] = 0x80;
+    stream[size + 1] = 0xAA;
+    check("run past the end", stream, size + 2, -1);
+
+    /* A literal claiming more bytes than the stream holds. */
+    stream[size] = 0x7F;
+    check("literal past the stream", stream, size + 5, -1);
+
+    /* One record covering more than the whole screen: runs of 130 from the start. */
+    for (uint16_t i = 0; i < 18; i++) {
+        stream[2 * i] = 0xFF;
+        stream[2 * i + 1] = (uint8_t)i;
+    }
+    check("oversized runs", stream, 36, -1);
+
+    printf("%lu rle mismatches, %u byte image\n", (unsigned long)failed, size);
+    return failed != 0;
+}
@@ -0,0 +1,200 @@
+#include "lcd_host.h"
+#include "drivers/lcd/lcd_draw.h"
+
+#include <string.h>
+
+/*
+ * The strobe sequence lcd_flush() puts on the bus, read back from the simulator trace
+ * ("E <chips> cmd|data <byte>"). A full frame must set page and column once per page on
+ * both chips together, then send the left and the right 64 bytes: 1040 strobes.
+ * Partial updates share only what both halves of a page have in common.
+ */
+#define LINE_MAX    32
+
+static struct lcd lcd;
+static struct lcd_bus_sim sim;
+static FILE *trace;
+static uint32_t failed;
+
+static void start(uint8_t wait_mode) {
+    trace = tmpfile();
+    lcd_host_init(&lcd, &sim, wait_mode, NULL);
+    sim.trace = trace;
+}
+
+/* Next E strobe of the trace, or an empty line at the end. */
+static void next_strobe(char *line) {
+    while (fgets(line, LINE_MAX, trace) != NULL) {
+        if (line[0] == 'E')
+            return;
+    }
+    line[0] = 0;
+}
+
+static void expect(const char *chips, const char *kind, uint8_t value) {
+    char line[LINE_MAX];
+    char expected[LINE_MAX];
+
+    next_strobe(line);
+    snprintf(expected, sizeof(expected), "E %s %s %02X\n", chips, kind, value);
+    if (strcmp(line, expected) != 0) {
+        if (failed < 10)
+            printf("expected \"E %s %s %02X\", got \"%.*s\"\n", chips, kind, value, (int)strcspn(line, "\n"), line);
+        failed++;
+    }
+}
+
+static void expect_data(const char *chips, uint8_t page, uint8_t column, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        expect(chips, "data", lcd.shadow.pages[page][column + i]);
+    }
+}
+
+static void expect_end(const char *test) {
+    char line[LINE_MAX];
+
+    next_strobe(line);
+    if (line[0] != 0) {
+        printf("%s: unexpected \"%.*s\"\n", test, (int)strcspn(line, "\n"), line);
+        failed++;
+    }
+    fclose(trace);
+}
+
+static void test_full_frame(void) {
+    static uint8_t bitmap[LCD_HEIGHT * LCD_WIDTH / 8];
+
+    for (uint16_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 37 + (i >> 4) + 1);
+    }
+    start(LCD_WAIT_DELAY);
+    lcd_show_bitmap(&lcd, bitmap);
+    lcd_flush(&lcd);
+    if (sim.strobes != 1040 || sim.commands != 16 || sim.data != 1024) {
+        printf("full frame: %lu strobes, %lu cmd, %lu data\n",
+               (unsigned long)sim.strobes, (unsigned long)sim.commands, (unsigned long)sim.data);
+        failed++;
+    }
+
+    rewind(trace);
+    for (uint8_t page = 0; page < LCD_PAGES; page++) {
+        expect("LR", "cmd", 0xB8|page);
+        expect("LR", "cmd", 0x40);
+        expect_data("L", page, 0, LCD_PART_WIDTH);
+        expect_data("R", page, LCD_PART_WIDTH, LCD_PART_WIDTH);
+    }
+    expect_end("full frame");
+}
+
+static void test_partial(void) {
+    start(LCD_WAIT_DELAY);
+    lcd_draw_pixel(&lcd, 10, 3, LCD_DRAW_SET);      /* page 0: both halves, other columns */
+    lcd_draw_pixel(&lcd, 100, 3, LCD_DRAW_SET);
+    lcd_draw_pixel(&lcd, 70, 20, LCD_DRAW_SET);     /* page 2: right half only */
+    lcd_draw_pixel(&lcd, 5, 33, LCD_DRAW_SET);      /* page 4: both halves, same column */
+    lcd_draw_pixel(&lcd, 69, 39, LCD_DRAW_SET);
+    lcd_draw_pixel(&lcd, 30, 50, LCD_DRAW_SET);     /* page 6: left half only */
+    lcd_flush(&lcd);
+
+    rewind(trace);
+    expect("LR", "cmd", 0xB8);
+    expect("L", "cmd", 0x40|10);
+    expect_data("L", 0, 10, 1);
+    expect("R", "cmd", 0x40|36);
+    expect_data("R", 0, 100, 1);
+
+    expect("R", "cmd", 0xBA);
+    expect("R", "cmd", 0x40|6);
+    expect_data("R", 2, 70, 1);
+
+    expect("LR", "cmd", 0xBC);
+    expect("LR", "cmd", 0x40|5);
+    expect_data("L", 4, 5, 1);
+    expect_data("R", 4, 69, 1);
+
+    expect("L", "cmd", 0xBE);
+    expect("L", "cmd", 0x40|30);
+    expect_data("L", 6, 30, 1);
+    expect_end("partial");
+}
+
+/* An area reaching past the right and bottom edges is resent up to the edges. */
+static void test_invalidate_edge(void) {
+    start(LCD_WAIT_DELAY);
+    if (lcd_invalidate(&lcd, 120, 60, 50, 20) != 0 || lcd_invalidate(&lcd, 0, 0, 0, 8) != -1 ||
+            lcd_invalidate(&lcd, LCD_WIDTH, 0, 1, 1) != -1) {
+        printf("invalidate edge: wrong return value\n");
+        failed++;
+    }
+    lcd_flush(&lcd);
+
+    rewind(trace);
+    expect("R", "cmd", 0xBF);
+    expect("R", "cmd", 0x40|56);
+    expect_data("R", 7, 120, 8);
+    expect_end("invalidate edge");
+}
+
+/* A panel stuck in BUSY costs LCD_BUSY_POLLS_MAX status reads once, then the writes go
+ * out with the fixed timings. */
+static void test_stuck_panel(void) {
+    static uint8_t expected[LCD_HEIGHT][LCD_WIDTH];
+
+    start(LCD_WAIT_BUSY);
+    sim.stuck = 1;
+    lcd_fill(&lcd, 1);
+    lcd_flush(&lcd);
+    memset(expected, 1, sizeof(expected));
+    if (lcd.busy_timeouts != 1 || lcd.wait_mode != LCD_WAIT_DELAY || sim.reads != LCD_BUSY_POLLS_MAX ||
+            lcd_host_compare(&sim, expected) != 0) {
+        printf("stuck panel: %lu timeouts, %lu status reads, wait mode %u\n", (unsigned long)lcd.busy_timeouts,
+               (unsigned long)sim.reads, lcd.wait_mode);
+        failed++;
+    }
+    fclose(trace);
+}
+
+/*
+ * Every E edge is followed by lcd_delay(), so E is high and low for at least its minimum
+ * time even where nothing else is written between two pulses: the repeated bytes of a
+ * fill, and the status reads right after a write in busy mode.
+ */
+static void test_timing(uint8_t wait_mode) {
+    const char *test = (wait_mode == LCD_WAIT_DELAY) ? "timing, delay mode" : "timing, busy mode";
+    char line[LINE_MAX];
+    uint32_t edges = 0;
+
+    start(wait_mode);
+    lcd_fill(&lcd, 1);
+    lcd_flush(&lcd);
+    lcd_draw_box(&lcd, 50, 20, 20, 10, LCD_DRAW_XOR);
+    lcd_flush(&lcd);
+
+    rewind(trace);
+    while (fgets(line, LINE_MAX, trace) != NULL) {
+        if (line[0] != 'E')
+            continue;
+        edges++;
+        if (fgets(line, LINE_MAX, trace) == NULL || strncmp(line, "DELAY", 5) != 0) {
+            if (failed < 10)
+                printf("%s: strobe %lu not followed by a delay\n", test, (unsigned long)edges);
+            failed++;
+        }
+    }
+    if (sim.short_edges != 0) {
+        printf("%s: %lu E edges without a delay\n", test, (unsigned long)sim.short_edges);
+        failed++;
+    }
+    fclose(trace);
+}
+
+int main(void) {
+    test_full_frame();
+    test_partial();
+    test_invalidate_edge();
+    test_stuck_panel();
+    test_timing(LCD_WAIT_DELAY);
+    test_timing(LCD_WAIT_BUSY);
+    printf("%lu strobe mismatches\n", (unsigned long)failed);
+    return failed != 0;
+}
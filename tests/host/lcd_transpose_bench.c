@@ -0,0 +1,52 @@
+#include "lcd_host.h"
+
+#include <time.h>
+
+/*
+ * Host time per 8x8 block of lcd_transpose8() and of the per-bit loop it replaced, over
+ * the blocks of one screen at the lcd_show_bitmap() stride. Only the ratio carries over
+ * to the Cortex-M3, the absolute numbers are those of the build machine.
+ */
+#define STRIDE  (LCD_WIDTH / 8)
+#define SCREENS 20000
+
+typedef void (*transpose_fn)(const uint8_t *rows, uint32_t stride, uint8_t *columns);
+
+static uint8_t bitmap[LCD_HEIGHT * STRIDE];
+static volatile uint8_t sink;
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double bench(transpose_fn transpose) {
+    uint8_t columns[8];
+    double start = now_ns();
+
+    for (uint32_t screen = 0; screen < SCREENS; screen++) {
+        for (uint8_t page = 0; page < LCD_PAGES; page++) {
+            for (uint8_t block = 0; block < STRIDE; block++) {
+                transpose(&bitmap[page * 8 * STRIDE + block], STRIDE, columns);
+                sink ^= columns[screen & 7];
+            }
+        }
+        bitmap[screen % sizeof(bitmap)]++;
+    }
+    return (now_ns() - start) / ((double)SCREENS * LCD_PAGES * STRIDE);
+}
+
+int main(void) {
+    for (uint16_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 37 + (i >> 3));
+    }
+
+    double bits = bench(lcd_host_transpose8_bits);
+    double words = bench(lcd_transpose8);
+
+    printf("per-bit loop      %6.2f ns/block\n", bits);
+    printf("lcd_transpose8()  %6.2f ns/block  (%.1fx)\n", words, bits / words);
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "lcd_host.h"
+
+#include <string.h>
+
+/*
+ * lcd_transpose8() against the per-bit loop it replaced: every single-bit block (the
+ * transpose is linear over GF(2), so these already cover all inputs), random blocks at
+ * the stride lcd_show_bitmap() uses, and a whole random screen through lcd_show_bitmap().
+ */
+#define RANDOM_BLOCKS   100000
+#define STRIDE          (LCD_WIDTH / 8)
+
+static uint32_t seed = 0x2545F491;
+
+static uint32_t random32(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static uint32_t check_block(const uint8_t *rows, uint32_t stride) {
+    uint8_t expected[8];
+    uint8_t columns[8];
+
+    lcd_host_transpose8_bits(rows, stride, expected);
+    lcd_transpose8(rows, stride, columns);
+    return memcmp(columns, expected, sizeof(columns)) != 0;
+}
+
+static uint32_t test_basis(void) {
+    uint8_t rows[8];
+    uint32_t failed = 0;
+
+    for (uint8_t bit = 0; bit < 64; bit++) {
+        memset(rows, 0, sizeof(rows));
+        rows[bit / 8] = 0x80 >> (bit % 8);
+        failed += check_block(rows, 1);
+    }
+    memset(rows, 0xFF, sizeof(rows));
+    return failed + check_block(rows, 1);
+}
+
+static uint32_t test_random(void) {
+    uint8_t rows[8 * STRIDE];
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < RANDOM_BLOCKS; i++) {
+        for (uint8_t row = 0; row < 8; row++) {
+            rows[row * STRIDE] = random32();
+        }
+        failed += check_block(rows, STRIDE);
+    }
+    return failed;
+}
+
+static uint32_t test_show_bitmap(void) {
+    static struct lcd lcd;
+    static struct lcd_bus_sim sim;
+    static uint8_t bitmap[LCD_HEIGHT * STRIDE];
+    uint32_t failed = 0;
+
+    for (uint16_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = random32();
+    }
+    lcd_host_init(&lcd, &sim, LCD_WAIT_DELAY, NULL);
+    lcd_show_bitmap(&lcd, bitmap);
+
+    for (uint8_t page = 0; page < LCD_PAGES; page++) {
+        for (uint8_t block = 0; block < STRIDE; block++) {
+            uint8_t expected[8];
+            lcd_host_transpose8_bits(&bitmap[page * 8 * STRIDE + block], STRIDE, expected);
+            if (memcmp(&lcd.shadow.pages[page][block * 8], expected, sizeof(expected)) != 0)
+                failed++;
+            for (uint8_t k = 0; k < 8; k++) {
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                    if (lcd_sim_pixel(&sim.panel, block * 8 + k, page * 8 + bit) != ((expected[k] >> bit) & 1))
+                        failed++;
+                }
+            }
+        }
+    }
+    return failed;
+}
+
+int main(void) {
+    uint32_t basis = test_basis();
+    uint32_t random = test_random();
+    uint32_t screen = test_show_bitmap();
+
+    printf("basis blocks failed %lu, random blocks failed %lu, screen mismatches %lu\n",
+           (unsigned long)basis, (unsigned long)random, (unsigned long)screen);
+    return (basis + random + screen) != 0;
+}
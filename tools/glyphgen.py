@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Converts a text bitmap font into a page-major C font for the LCD driver.
+
+Usage: glyphgen.py <font.txt> <output base path>
+
+Writes <base>.c and <base>.h defining `const struct lcd_font lcd_<name>`, where
+<name> is the base file name. Glyph columns are stored the way the panel RAM
+holds them: one byte per column and page row, LSB on top, so page-aligned text
+is copied to the framebuffer or the bus without any transposing.
+
+Font file format:
+    height <pixels>             glyph height, the same for all glyphs
+    spacing <columns>           blank columns drawn after every glyph
+    char <code> [comment]       starts a glyph, followed by <height> rows
+    ..##..                      '#' is a set pixel, '.' a clear one
+Lines starting with '#' before the first glyph and blank lines are ignored.
+Glyph codes must be consecutive.
+"""
+
+import os
+import sys
+
+MAX_WIDTH = 16  # LCD_FONT_MAX_WIDTH in lcd_font.h
+
+
+def fail(path, line, message):
+    sys.exit("%s:%d: %s" % (path, line, message))
+
+
+def parse(path):
+    height = None
+    spacing = 0
+    glyphs = []
+    rows = None
+
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.rstrip("\n").rstrip()
+            if rows is not None and len(rows) < height:
+                if not line or set(line) - set("#."):
+                    fail(path, number, "expected a glyph row")
+                if rows and len(line) != len(rows[0]):
+                    fail(path, number, "glyph rows differ in width")
+                rows.append(line)
+                continue
+
+            if not line or (rows is None and line.startswith("#")):
+                continue
+            fields = line.split()
+            if fields[0] == "height":
+                height = int(fields[1])
+            elif fields[0] == "spacing":
+                spacing = int(fields[1])
+            elif fields[0] == "char":
+                if height is None:
+                    fail(path, number, "height must come before the first glyph")
+                code = int(fields[1], 0)
+                if glyphs and code != glyphs[-1][0] + 1:
+                    fail(path, number, "glyph codes must be consecutive")
+                rows = []
+                glyphs.append((code, rows))
+            else:
+                fail(path, number, "unknown keyword '%s'" % fields[0])
+
+    if not glyphs or len(glyphs[-1][1]) < height:
+        sys.exit("%s: truncated font" % path)
+    for code, rows in glyphs:
+        if len(rows[0]) + spacing > MAX_WIDTH:
+            sys.exit("%s: glyph 0x%02X is wider than %d columns" % (path, code, MAX_WIDTH))
+    return height, spacing, glyphs
+
+
+def page_major(rows, pages):
+    """Columns of every page row, top page first."""
+    data = []
+    for page in range(pages):
+        for x in range(len(rows[0])):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < len(rows) and rows[y][x] == "#":
+                    byte |= 1 << bit
+            data.append(byte)
+    return data
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    source, base = sys.argv[1], sys.argv[2]
+    name = os.path.basename(base)
+    height, spacing, glyphs = parse(source)
+    pages = (height + 7) // 8
+
+    bitmap = []
+    offsets = []
+    lines = []
+    for code, rows in glyphs:
+        data = page_major(rows, pages)
+        offsets.append(len(bitmap))
+        label = chr(code) if 0x20 < code < 0x7F and chr(code) not in "\\*/" else "0x%02X" % code
+        lines.append("    /* %s */ %s," % (label, ", ".join("0x%02X" % b for b in data)))
+        bitmap += data
+    offsets.append(len(bitmap))
+
+    guard = "LCD_%s_H_" % name.upper()
+    with open(base + ".h", "w") as f:
+        f.write("/* Generated by tools/glyphgen.py from %s, do not edit. */\n" % os.path.basename(source))
+        f.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        f.write('#include "drivers/lcd/lcd_font.h"\n\n')
+        f.write("extern const struct lcd_font lcd_%s;\n\n#endif\n" % name)
+
+    with open(base + ".c", "w") as f:
+        f.write("/* Generated by tools/glyphgen.py from %s, do not edit. */\n" % os.path.basename(source))
+        f.write('#include "%s.h"\n\n' % name)
+        f.write("static const uint8_t bitmap[] = {\n%s\n};\n\n" % "\n".join(lines))
+        f.write("static const uint16_t offsets[] = {\n")
+        for i in range(0, len(offsets), 12):
+            f.write("    %s,\n" % ", ".join(str(o) for o in offsets[i:i + 12]))
+        f.write("};\n\n")
+        f.write("const struct lcd_font lcd_%s = {\n" % name)
+        f.write("    .first = 0x%02X,\n" % glyphs[0][0])
+        f.write("    .count = %d,\n" % len(glyphs))
+        f.write("    .height = %d,\n" % height)
+        f.write("    .pages = %d,\n" % pages)
+        f.write("    .spacing = %d,\n" % spacing)
+        f.write("    .offsets = offsets,\n")
+        f.write("    .bitmap = bitmap\n")
+        f.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
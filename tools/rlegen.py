@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Compresses a 128x64 screen image into the page-major RLE format of the LCD driver.
+
+Usage: rlegen.py <image> <output base path>
+
+<image> is a PBM file (P1 or P4, 128x64, 1 is a set pixel) or a raw 1024 byte
+page-major dump such as an lcd_framebuffer. Writes <base>.c and <base>.h
+defining `const struct lcd_rle_image lcd_image_<name>`, where <name> is the
+base file name, to be drawn with lcd_show_rle().
+
+Stream format, bytes in panel order (page 0 columns 0..127, then page 1, ...):
+    0x00..0x7F c    literal: the next c + 1 bytes
+    0x80..0xFF c    run: the next byte repeated (c & 0x7F) + 3 times
+Runs and literals may cross page rows; the stream covers all 1024 bytes.
+"""
+
+import os
+import sys
+
+WIDTH = 128
+HEIGHT = 64
+RUN_MIN = 3         # LCD_RLE_RUN_MIN in lcd_rle.h
+RUN_MAX = 0x7F + RUN_MIN
+LITERAL_MAX = 0x80
+
+
+def read_pbm(path, raw):
+    """Returns the page-major frame of a P1 or P4 bitmap."""
+    tokens = []
+    pos = 0
+    # The header is whitespace separated, with '#' comments up to the end of a line.
+    while len(tokens) < 3:
+        while raw[pos:pos + 1].isspace():
+            pos += 1
+        if raw[pos:pos + 1] == b"#":
+            while raw[pos:pos + 1] not in (b"\n", b""):
+                pos += 1
+            continue
+        start = pos
+        while pos < len(raw) and not raw[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(raw[start:pos])
+
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if (width, height) != (WIDTH, HEIGHT):
+        sys.exit("%s: image is %dx%d, expected %dx%d" % (path, width, height, WIDTH, HEIGHT))
+
+    if magic == b"P4":
+        data = raw[pos + 1:]
+        stride = (WIDTH + 7) // 8
+        if len(data) < stride * HEIGHT:
+            sys.exit("%s: truncated image" % path)
+        pixel = lambda x, y: (data[y * stride + x // 8] >> (7 - x % 8)) & 1
+    elif magic == b"P1":
+        bits = [c for c in raw[pos:].decode("ascii") if c in "01"]
+        if len(bits) < WIDTH * HEIGHT:
+            sys.exit("%s: truncated image" % path)
+        pixel = lambda x, y: int(bits[y * WIDTH + x])
+    else:
+        sys.exit("%s: not a P1 or P4 bitmap" % path)
+
+    frame = []
+    for page in range(HEIGHT // 8):
+        for x in range(WIDTH):
+            frame.append(sum(pixel(x, page * 8 + bit) << bit for bit in range(8)))
+    return frame
+
+
+def encode(frame):
+    out = []
+    literal = []
+    i = 0
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:LITERAL_MAX]
+            del literal[:LITERAL_MAX]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    while i < len(frame):
+        run = 1
+        while i + run < len(frame) and run < RUN_MAX and frame[i + run] == frame[i]:
+            run += 1
+        if run >= RUN_MIN:
+            flush_literal()
+            out += [0x80 | (run - RUN_MIN), frame[i]]
+            i += run
+        else:
+            literal.append(frame[i])
+            i += 1
+    flush_literal()
+    return out
+
+
+def decode(stream):
+    frame = []
+    i = 0
+    while i < len(stream):
+        control = stream[i]
+        if control & 0x80:
+            frame += [stream[i + 1]] * ((control & 0x7F) + RUN_MIN)
+            i += 2
+        else:
+            frame += stream[i + 1:i + 2 + control]
+            i += control + 2
+    return frame
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    source, base = sys.argv[1], sys.argv[2]
+    name = os.path.basename(base)
+    with open(source, "rb") as f:
+        raw = f.read()
+
+    if raw[:1] == b"P":
+        frame = read_pbm(source, raw)
+    elif len(raw) == WIDTH * HEIGHT // 8:
+        frame = list(raw)
+    else:
+        sys.exit("%s: neither a PBM file nor a %d byte page-major dump" % (source, WIDTH * HEIGHT // 8))
+
+    stream = encode(frame)
+    assert decode(stream) == frame
+
+    guard = "LCD_IMAGE_%s_H_" % name.upper()
+    with open(base + ".h", "w") as f:
+        f.write("/* Generated by tools/rlegen.py from %s, do not edit. */\n" % os.path.basename(source))
+        f.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        f.write('#include "drivers/lcd/lcd_rle.h"\n\n')
+        f.write("extern const struct lcd_rle_image lcd_image_%s;\n\n#endif\n" % name)
+
+    with open(base + ".c", "w") as f:
+        f.write("/* Generated by tools/rlegen.py from %s, do not edit. */\n" % os.path.basename(source))
+        f.write("/* %d bytes, %d%% of the raw frame. */\n" % (len(stream), len(stream) * 100 // len(frame)))
+        f.write('#include "%s.h"\n\n' % name)
+        f.write("static const uint8_t data[] = {\n")
+        for i in range(0, len(stream), 16):
+            f.write("    %s,\n" % ", ".join("0x%02X" % b for b in stream[i:i + 16]))
+        f.write("};\n\n")
+        f.write("const struct lcd_rle_image lcd_image_%s = {\n" % name)
+        f.write("    .size = sizeof(data),\n")
+        f.write("    .data = data\n")
+        f.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Worst-case stack depth of call trees, from GCC's -fcallgraph-info=su output.
+
+Usage: stackusage.py [--indirect f,g,...] <task>=<entry>,<entry>... <path>...
+
+<path> is a .ci file or a directory searched for them. Every <task> is
+reported with the deepest path through any of its entry functions: the frame
+size of each function on it and their sum. Calls through function pointers
+go to every function named with --indirect (the transport callbacks, say),
+which overestimates; such a call leading back into its own caller is not
+taken as recursion. Functions without a frame size in the .ci files, such
+as library calls, count as 0 bytes and are listed as not measured.
+"""
+
+import os
+import re
+import sys
+
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r'\\n(\d+) bytes \((static|dynamic|dynamic,bounded)\)')
+INDIRECT = "__indirect_call"
+
+
+def name_of(title):
+    """Function name of a node title, which is "<file>:<name>" for static functions."""
+    return title.rsplit(":", 1)[-1]
+
+
+def ci_files(paths):
+    for path in paths:
+        if not os.path.isdir(path):
+            yield path
+            continue
+        for root, _, names in sorted(os.walk(path)):
+            for name in sorted(names):
+                if name.endswith(".ci"):
+                    yield os.path.join(root, name)
+
+
+def parse(paths):
+    frames = {}
+    dynamic = set()
+    calls = {}
+    for path in ci_files(paths):
+        with open(path) as f:
+            for line in f:
+                node = NODE.search(line)
+                if node:
+                    frame = FRAME.search(node.group(2))
+                    if frame:
+                        frames[node.group(1)] = int(frame.group(1))
+                        if frame.group(2) != "static":
+                            dynamic.add(node.group(1))
+                    continue
+                edge = EDGE.search(line)
+                if edge:
+                    calls.setdefault(edge.group(1), set()).add(edge.group(2))
+    return frames, dynamic, calls
+
+
+def main():
+    args = sys.argv[1:]
+    indirect = []
+    if len(args) >= 2 and args[0] == "--indirect":
+        indirect = args[1].split(",")
+        args = args[2:]
+    tasks = [a for a in args if "=" in a]
+    paths = [a for a in args if "=" not in a]
+    if not tasks or not paths:
+        sys.exit(__doc__.strip().splitlines()[2])
+
+    frames, dynamic, calls = parse(paths)
+    calls[INDIRECT] = {t for t in frames if name_of(t) in indirect}
+    unknown = set()
+
+    # No memo: what an indirect call reaches depends on the path. A cycle through one
+    # is taken as not recursive, e.g. a transport callback polling read_status.
+    def deepest(title, stack):
+        if title in stack:
+            if INDIRECT in stack[stack.index(title):]:
+                return (0, [])
+            sys.exit("recursion: %s" % " -> ".join(name_of(t) for t in stack + [title]))
+        if title not in frames and title != INDIRECT:
+            unknown.add(name_of(title))
+        best = (0, [])
+        for callee in sorted(calls.get(title, ())):
+            best = max(best, deepest(callee, stack + [title]), key=lambda b: b[0])
+        path = [title] if title != INDIRECT else []
+        return (frames.get(title, 0) + best[0], path + best[1])
+
+    for task in tasks:
+        name, entries = task.split("=", 1)
+        titles = []
+        for entry in entries.split(","):
+            found = [t for t in frames if name_of(t) == entry]
+            if not found:
+                sys.exit("%s: no frame size for %s" % (name, entry))
+            titles += found
+        total, path = max((deepest(t, []) for t in titles), key=lambda b: b[0])
+        print("%-16s %5d bytes" % (name, total))
+        for title in path:
+            flag = " (dynamic)" if title in dynamic else ""
+            print("    %5d  %s%s" % (frames.get(title, 0), name_of(title), flag))
+    if unknown:
+        print("not measured: %s" % ", ".join(sorted(unknown)))
+
+
+if __name__ == "__main__":
+    main()